@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// counts the heap allocations of the program, to check that steady state ticks don't allocate
+// define ENSYS_ALLOCATION_COUNTING in exactly one translation unit (e.g. the one of a test or benchmark main) before
+// including this header, it then replaces the global operator new and delete, without it the counts stay zero
+namespace tenjix {
+
+	namespace ensys {
+
+		// the number of heap allocations performed by all threads so far
+		class Allocations final {
+
+		public:
+
+			// returns the total number of allocations
+			static uint64_t count() {
+				return counter().load(std::memory_order_relaxed);
+			}
+
+			// counts an allocation, called by the replaced operator new
+			static void add() {
+				counter().fetch_add(1, std::memory_order_relaxed);
+			}
+
+		private:
+
+			static std::atomic<uint64_t>& counter() {
+				static std::atomic<uint64_t> allocations(0);
+				return allocations;
+			}
+
+		};
+
+		// counts the allocations performed during its lifetime (by all threads)
+		class AllocationScope final {
+
+			const uint64_t start = Allocations::count();
+
+		public:
+
+			// returns the number of allocations since the scope was entered
+			uint64_t get_number_of_allocations() const {
+				return Allocations::count() - start;
+			}
+
+		};
+
+	}
+
+}
+
+#ifdef ENSYS_ALLOCATION_COUNTING
+
+void* operator new(std::size_t size) {
+	::tenjix::ensys::Allocations::add();
+	if (void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	::tenjix::ensys::Allocations::add();
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t size) noexcept {
+	std::free(memory);
+}
+
+#endif
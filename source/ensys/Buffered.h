@@ -0,0 +1,151 @@
+#pragma once
+
+#include <atomic>
+#include <limits>
+#include <memory>
+
+#include <ensys/System.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// base of component buffers, which get swapped by the world at the end of each update
+		class Buffer {
+
+			friend class World;
+
+		public:
+
+			virtual ~Buffer() noexcept {}
+
+		private:
+
+			// publishes the current component values to readers
+			virtual void swap() = 0;
+
+		};
+
+		template <class ComponentType>
+		class DoubleBuffer;
+
+		// an immutable copy of the values of a buffered component type, as they were at the end of a tick
+		template <class ComponentType>
+		class BufferedView final {
+
+			friend class DoubleBuffer<ComponentType>;
+
+			static constexpr uint No_Index = std::numeric_limits<uint>::max();
+
+			unsigned long long tick = 0;
+
+			Lot<Entity::Id> ids;
+			Lot<ComponentType> values;
+			// the index of the value of each entity by id (No_Index for entities without value), reused across ticks
+			Lot<uint> indices;
+
+		public:
+
+			// returns the number of the tick this view was published at
+			unsigned long long get_tick() const {
+				return tick;
+			}
+
+			// checks whether this view contains a value of the entity with the given id
+			bool contains(Entity::Id id) const {
+				return id < indices.size() and indices[id] != No_Index;
+			}
+
+			// returns the value of the entity with the given id (or nullptr if there is none)
+			const ComponentType* find(Entity::Id id) const {
+				if (not contains(id)) return nullptr;
+				return &values[indices[id]];
+			}
+
+			// returns the ids of all entities in this view (ordered like the values)
+			const Lot<Entity::Id>& get_ids() const {
+				return ids;
+			}
+
+			// returns the values of all entities in this view (ordered like the ids)
+			const Lot<ComponentType>& get_values() const {
+				return values;
+			}
+
+			// returns the number of values in this view
+			uint size() const {
+				return values.size();
+			}
+
+		};
+
+		template <class ComponentType>
+		constexpr uint BufferedView<ComponentType>::No_Index;
+
+		// double buffers the values of a component type for concurrent readers
+		// readers get the values of the previous tick through read() from any thread, without locking the world,
+		// while the systems write the next tick, the world publishes the new values at the end of each update
+		template <class ComponentType>
+		class DoubleBuffer final : public System, public Buffer {
+
+			using View = BufferedView<ComponentType>;
+
+			// the view read by readers (accessed atomically)
+			shared<const View> front;
+			// the previously published view, reused when no reader holds it anymore
+			shared<View> back;
+
+			unsigned long long tick = 0;
+
+		public:
+
+			explicit DoubleBuffer(Priority priority = 0, UpdateStage stage = UpdateStage::Update) : System(priority, stage), front(std::make_shared<View>()) {
+				filter.require<ComponentType>();
+			}
+
+			// returns the values published at the end of the last update (thread safe)
+			shared<const View> read() const {
+				return std::atomic_load(&front);
+			}
+
+		private:
+
+			void update(float delta_time) override {}
+
+			// copies the current values into the back view and swaps it with the front view
+			// a reused view keeps its memory, only the index slots of its former entities get reset and its values get assigned in place
+			// (keeping the memory of their members), so steady ticks don't allocate
+			void swap() override {
+				bool reusable = back and back.use_count() == 1;
+				// pairs with the release of the last reader's reference, so its reads of the view happen before the writes below
+				std::atomic_thread_fence(std::memory_order_acquire);
+				shared<View> next = reusable ? std::move(back) : std::make_shared<View>();
+				next->tick = ++tick;
+				for (Entity::Id id : next->ids) {
+					next->indices[id] = View::No_Index;
+				}
+				next->ids.clear();
+				next->ids.reserve(get_number_of_entities());
+				next->values.reserve(get_number_of_entities());
+				uint size = 0;
+				for (auto& entity : get_entities()) {
+					if (entity.id >= next->indices.size()) next->indices.resize(entity.id + 1, View::No_Index);
+					next->indices[entity.id] = size;
+					next->ids.push_back(entity.id);
+					const ComponentType& value = entity.get<ComponentType>();
+					if (size < next->values.size()) next->values[size] = value;
+					else next->values.push_back(value);
+					size++;
+				}
+				next->values.erase(next->values.begin() + size, next->values.end());
+				shared<const View> published = std::move(next);
+				back = std::const_pointer_cast<View>(std::atomic_exchange(&front, published));
+			}
+
+		};
+
+	}
+
+}
@@ -0,0 +1,111 @@
+#include "Cold.h"
+
+#include <utility>
+
+#include <ensys/Registry.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// keeps an entry for cold entities without components too, so thawing knows which entities to move back
+		void ColdComponents::freeze_entity(Entity::Id entity, ComponentMap&& components, Storages& storages) {
+			number_of_components += components.size();
+			entities[entity] = std::move(components);
+			for (auto& storage : storages) {
+				if (storage.second.get() != this and storage.second->freeze(entity)) this->storages.insert(storage.second.get());
+			}
+		}
+
+		void ColdComponents::thaw_entity(Entity::Id entity, ComponentMap& components, Storages& storages) {
+			auto iterator = entities.find(entity);
+			if (iterator == entities.end()) return;
+			number_of_components -= iterator->second.size();
+			if (components.empty()) components = std::move(iterator->second);
+			else components.insert(iterator->second.begin(), iterator->second.end());
+			entities.erase(iterator);
+			for (auto& storage : storages) {
+				if (this->storages.count(storage.second.get())) storage.second->thaw(entity);
+			}
+		}
+
+		shared<Component> ColdComponents::find(Entity::Id entity, Type type) const {
+			const ComponentMap* components = find(entity);
+			if (not components) return shared<Component>();
+			auto iterator = components->find(type);
+			return iterator == components->end() ? shared<Component>() : iterator->second;
+		}
+
+		const ColdComponents::ComponentMap* ColdComponents::find(Entity::Id entity) const {
+			auto iterator = entities.find(entity);
+			return iterator == entities.end() ? nullptr : &iterator->second;
+		}
+
+		uint ColdComponents::get_number_of_entities() const {
+			return entities.size();
+		}
+
+		uint ColdComponents::get_number_of_components() const {
+			return number_of_components;
+		}
+
+		size_t ColdComponents::get_number_of_bytes() const {
+			size_t bytes = entities.bucket_count() * sizeof(void*);
+			for (auto& entity : entities) {
+				bytes += sizeof(entity) + entity.second.bucket_count() * sizeof(void*);
+				for (auto& component : entity.second) {
+					bytes += sizeof(component) + sizeof(void*);
+					const ComponentInfo* info = ComponentRegistry::find(component.first);
+					if (info) bytes += info->size;
+				}
+			}
+			for (const Storage* storage : storages) {
+				bytes += storage->get_number_of_cold_bytes();
+			}
+			return bytes;
+		}
+
+		bool ColdComponents::contains(Entity::Id entity) const {
+			return entities.find(entity) != entities.end();
+		}
+
+		// cold components still belong to the type signature of their entity
+		void ColdComponents::collect(Entity::Id entity, Types& types) const {
+			const ComponentMap* components = find(entity);
+			if (not components) return;
+			for (auto& component : *components) {
+				types.insert(component.first);
+			}
+		}
+
+		void ColdComponents::release(Entity::Id entity) {
+			auto iterator = entities.find(entity);
+			if (iterator == entities.end()) return;
+			number_of_components -= iterator->second.size();
+			entities.erase(iterator);
+		}
+
+		void ColdComponents::clear() {
+			entities.clear();
+			storages.clear();
+			number_of_components = 0;
+		}
+
+		void ColdComponents::renumber(Entity::Id from, Entity::Id to) {
+			auto iterator = entities.find(from);
+			if (iterator == entities.end()) return;
+			ComponentMap components = std::move(iterator->second);
+			entities.erase(iterator);
+			entities.emplace(to, std::move(components));
+		}
+
+		void ColdComponents::shrink() {
+			entities.rehash(0);
+			for (auto& entity : entities) {
+				entity.second.rehash(0);
+			}
+		}
+
+	}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <ensys/Component.h>
+#include <ensys/Entity.h>
+#include <ensys/Storage.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// the components of deactivated entities moved out of the component map of their world,
+		// kept per entity until their entity gets activated again, the other storages (e.g. tables) move their data aside meanwhile
+		// (the components keep their addresses, only their map entries leave the hot map)
+		class ColdComponents final : public Storage {
+
+		public:
+
+			using ComponentMap = Map<Type, shared<Component>>;
+
+		private:
+
+			Map<Entity::Id, ComponentMap> entities;
+
+			// the storages which moved data of cold entities aside
+			Set<const Storage*> storages;
+
+			uint number_of_components = 0;
+
+		public:
+
+			// moves the components into the cold store of the entity with the given id and the data of the entity in the given storages aside
+			void freeze_entity(Entity::Id entity, ComponentMap&& components, Storages& storages);
+
+			// moves the components of the entity with the given id back into the given map and its data in the given storages back in place
+			void thaw_entity(Entity::Id entity, ComponentMap& components, Storages& storages);
+
+			// returns the component of the given type of the entity with the given id (or nullptr if there is none)
+			shared<Component> find(Entity::Id entity, Type type) const;
+
+			// returns the cold components of the entity with the given id (or nullptr if the entity isn't cold)
+			const ComponentMap* find(Entity::Id entity) const;
+
+			// returns the number of cold entities
+			uint get_number_of_entities() const;
+
+			// returns the number of cold components
+			uint get_number_of_components() const;
+
+			// returns the approximate memory held by cold entities in bytes, including the data other storages moved aside
+			// (component sizes are known for types registered with the component registry)
+			size_t get_number_of_bytes() const;
+
+			bool contains(Entity::Id entity) const override;
+			void collect(Entity::Id entity, Types& types) const override;
+			void release(Entity::Id entity) override;
+			void clear() override;
+			void renumber(Entity::Id from, Entity::Id to) override;
+			void shrink() override;
+
+		};
+
+	}
+
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
+
+#include <ensys/Trace.h>
+
 #include <utilities/Logging.h>
 #include <utilities/Standard.h>
 
@@ -11,18 +16,28 @@ namespace tenjix {
 
 		public:
 
+			// components may be constructed on other threads than the one of their world (e.g. when staging cells),
+			// so they only record to the per thread trace buffers
 			Component() {
-				trace("constructing component [", this, "]");
+				ensys_trace(Construct_Component, reinterpret_cast<uintptr_t>(this), 0);
 			}
 
 			virtual	~Component() noexcept {
-				trace("destructing component [", this, "]");
+				ensys_trace(Destruct_Component, reinterpret_cast<uintptr_t>(this), 0);
 			}
 
 		};
 
 		using Components = Lot<linked<Component>>;
 
+		// base of zero size tag components, which only exist in the type signature of their entities
+		// e.g. struct Stunned : Tag {}; entity.add<Stunned>();
+		struct Tag {};
+
+		// checks whether the given type is a tag component
+		template <class ComponentType>
+		struct is_tag : std::integral_constant<bool, std::is_base_of<Tag, ComponentType>::value and std::is_empty<ComponentType>::value> {};
+
 	}
 
 }
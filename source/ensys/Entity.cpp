@@ -1,5 +1,6 @@
 #include "Entity.h"
 
+#include <ensys/Trace.h>
 #include <ensys/World.h>
 
 #include <utilities/Logging.h>
@@ -12,6 +13,7 @@ namespace tenjix {
 			name.owner = this;
 			tag.owner = this;
 			is_active.owner = this;
+			is_enabled.owner = this;
 			is_existing.owner = this;
 		}
 
@@ -23,8 +25,18 @@ namespace tenjix {
 			return *this;
 		}
 
-		Entity& Entity::deactivate() {
-			world.deactivate_entity(*this);
+		Entity& Entity::deactivate(bool cold) {
+			world.deactivate_entity(*this, cold);
+			return *this;
+		}
+
+		Entity& Entity::enable() {
+			world.enable_entity(*this);
+			return *this;
+		}
+
+		Entity& Entity::disable() {
+			world.disable_entity(*this);
 			return *this;
 		}
 
@@ -32,25 +44,80 @@ namespace tenjix {
 			world.destroy_entity(*this);
 		}
 
+		Entity& Entity::set_parent(const Entity& parent) {
+			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't set parent");
+			runtime_assert(parent.is_existing(), "there is no existing entity with id #", parent.id, " can't attach ", *this, " to it");
+			trace("attaching ", *this, " to ", parent);
+			world.hierarchy.attach(id, parent.id);
+			return *this;
+		}
+
+		Entity& Entity::remove_parent() {
+			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't remove parent");
+			trace("detaching ", *this, " from its parent");
+			world.hierarchy.detach(id);
+			return *this;
+		}
+
+		bool Entity::has_parent() const {
+			return world.hierarchy.get_parent(id) != IDs::No_Id;
+		}
+
+		Entity Entity::get_parent() const {
+			return world.get_entity(world.hierarchy.get_parent(id));
+		}
+
+		const Lot<Entity::Id>& Entity::get_children() const {
+			return world.hierarchy.get_children(id);
+		}
+
 		uint Entity::get_number_of_components() const {
 			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't determine number of components");
-			auto& components = world.components[id];
-			return components.size();
+			auto iterator = world.components.find(id);
+			if (iterator != world.components.end()) return iterator->second.size();
+			const ColdComponents* cold = world.find_cold_components();
+			auto entries = cold ? cold->find(id) : nullptr;
+			return entries ? entries->size() : 0;
 		}
 
 		const Components Entity::get_components() const {
 			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't retrieve components");
 			Components components;
-			for (auto& pair : world.components[id]) {
+			for (auto& pair : find_components()) {
 				components.push_back(pair.second);
 			}
 			return components;
 		}
 
+		Entity::ComponentRange Entity::get_component_range() const {
+			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't retrieve components");
+			const ComponentMap& components = find_components();
+			return ComponentRange(components.begin(), components.end(), components.size());
+		}
+
+		Entity::ComponentTypeRange Entity::get_component_type_range() const {
+			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't determine component types");
+			const ComponentMap& components = find_components();
+			return ComponentTypeRange(components.begin(), components.end(), components.size());
+		}
+
+		// the components of cold entities are kept by the cold store, which keeps their map
+		const Entity::ComponentMap& Entity::find_components() const {
+			static const ComponentMap no_components;
+			auto iterator = world.components.find(id);
+			if (iterator != world.components.end()) return iterator->second;
+			const ColdComponents* cold = world.find_cold_components();
+			const ComponentMap* components = cold ? cold->find(id) : nullptr;
+			return components ? *components : no_components;
+		}
+
 		void Entity::remove_all_components() {
 			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't remove components");
 			trace("removing all components from ", *this);
-			auto& components = world.components[id];
+			world.thaw(id);
+			auto entity_components = world.components.find(id);
+			if (entity_components == world.components.end()) return;
+			auto& components = entity_components->second;
 			auto iterator = components.begin();
 			uint n = 0;
 			while (iterator != components.end()) {
@@ -64,8 +131,14 @@ namespace tenjix {
 		const Types Entity::get_component_types() const {
 			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't determine component types");
 			Types types;
-			for (auto& pair : world.components[id]) {
-				types.insert(pair.first);
+			auto iterator = world.components.find(id);
+			if (iterator != world.components.end()) {
+				for (auto& pair : iterator->second) {
+					types.insert(pair.first);
+				}
+			}
+			for (auto& entry : world.storages) {
+				entry.second->collect(id, types);
 			}
 			return types;
 		}
@@ -111,6 +184,10 @@ namespace tenjix {
 			return world.is_active(id);
 		}
 
+		bool Entity::get_is_enabled() const {
+			return world.is_enabled(id);
+		}
+
 		bool Entity::get_is_existing() const {
 			return world.is_existing(id);
 		}
@@ -118,28 +195,35 @@ namespace tenjix {
 		/// template implementation details
 
 		void Entity::add(Type component_type, const shared<Component>& component) {
-			trace("adding ", component_type, " to ", *this);
+			ensys_trace(Add_Component, id, component_type.hash_code());
+			if (world.recorder) world.recorder->add_component(id, component_type);
+			world.thaw(id);
 			world.components[id].emplace(component_type, component);
 			world.update_systems(*this);
 		}
 
 		void Entity::remove(Type component_type) {
-			trace("removing ", component_type, " from ", *this);
-			auto& components = world.components[id];
-			auto iterator = components.find(component_type);
-			runtime_assert(iterator != components.end(), *this, " doesn't have a component of type ", component_type, ", can't remove it");
-			components.erase(iterator);
+			ensys_trace(Remove_Component, id, component_type.hash_code());
+			if (world.recorder) world.recorder->remove_component(id, component_type);
+			world.thaw(id);
+			auto entity_components = world.components.find(id);
+			bool found = entity_components != world.components.end() and entity_components->second.erase(component_type);
+			runtime_assert(found, *this, " doesn't have a component of type ", component_type, ", can't remove it");
 			world.update_systems(*this);
 		}
 
 		bool Entity::has(Type component_type) const {
-			auto& components = world.components[id];
-			auto iterator = components.find(component_type);
-			return iterator != components.end();
+			return bool(get(component_type));
 		}
 
+		// looks up the cold store only for entities without an entry in the component map
 		shared<Component> Entity::get(Type component_type) const {
-			auto& components = world.components[id];
+			auto entity_components = world.components.find(id);
+			if (entity_components == world.components.end()) {
+				const ColdComponents* cold = world.find_cold_components();
+				return cold ? cold->find(id, component_type) : shared<Component>();
+			}
+			auto& components = entity_components->second;
 			auto iterator = components.find(component_type);
 			if (iterator == components.end()) return shared<Component>();
 			return iterator->second;
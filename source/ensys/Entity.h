@@ -3,6 +3,8 @@
 #include <iostream>
 
 #include <ensys/Component.h>
+#include <ensys/Range.h>
+#include <ensys/Registry.h>
 
 #include <utilities/Assertions.h>
 #include <utilities/Properties.h>
@@ -17,6 +19,8 @@ namespace tenjix {
 
 			friend class World;
 
+			using ComponentMap = Map<Type, shared<Component>>;
+
 			const String& get_name() const;
 			void set_name(Assignment<String>);
 
@@ -24,6 +28,7 @@ namespace tenjix {
 			void set_tag(Assignment<String>);
 
 			bool get_is_active() const;
+			bool get_is_enabled() const;
 			bool get_is_existing() const;
 
 		public:
@@ -48,6 +53,8 @@ namespace tenjix {
 			ByReferenceProperty<String, Entity, &Entity::get_tag, &Entity::set_tag> tag;
 			// checks whether this entity is existing and active
 			ReadonlyByValueProperty<bool, Entity, &Entity::get_is_active> is_active;
+			// checks whether this entity is existing and enabled
+			ReadonlyByValueProperty<bool, Entity, &Entity::get_is_enabled> is_enabled;
 			// checks whether this entity is existing
 			ReadonlyByValueProperty<bool, Entity, &Entity::get_is_existing> is_existing;
 
@@ -55,11 +62,33 @@ namespace tenjix {
 			Entity& activate();
 
 			// deactivates this entity, excluding it from system updates
-			Entity& deactivate();
+			// (cold entities move their components out of the component map of their world until they get activated)
+			Entity& deactivate(bool cold = false);
+
+			// enables this entity, including it in system iterations again
+			Entity& enable();
+
+			// disables this entity, skipping it in system iterations while keeping its system membership
+			Entity& disable();
 
-			// destroys this entity with all its components
+			// destroys this entity with all its components and descendants
 			void destroy();
 
+			// attaches this entity as child to the given parent entity
+			Entity& set_parent(const Entity& parent);
+
+			// detaches this entity from its parent
+			Entity& remove_parent();
+
+			// checks whether this entity has a parent
+			bool has_parent() const;
+
+			// returns the parent of this entity
+			Entity get_parent() const;
+
+			// returns the ids of the children of this entity
+			const Lot<Id>& get_children() const;
+
 			template <class... ComponentTypes>
 			void add_components();
 
@@ -93,6 +122,24 @@ namespace tenjix {
 			template <class ComponentType>
 			bool shares() const;
 
+			template <class ValueType>
+			const ValueType& add_shared_value(const ValueType& value);
+
+			template <class ValueType>
+			void remove_shared_value();
+
+			template <class ValueType>
+			bool has_shared_value() const;
+
+			template <class ValueType>
+			const ValueType& get_shared_value() const;
+
+			template <class... ComponentTypes>
+			void add_plain_components(const ComponentTypes&... components);
+
+			template <class... ComponentTypes>
+			void remove_plain_components();
+
 			const Types get_component_types() const;
 
 			// returns the number of components owned by this entity
@@ -101,6 +148,18 @@ namespace tenjix {
 			// returns a collection of all components owned by this entity
 			const Components get_components() const;
 
+			// a view over the components of an entity or their types, iterating without allocating
+			using ComponentRange = Range<ComponentMap::const_iterator, ValueProjection>;
+			using ComponentTypeRange = Range<ComponentMap::const_iterator, KeyProjection>;
+
+			// returns a view over the components owned by this entity, without copying them
+			// (plain components and shared values are kept in storages and not part of the view)
+			ComponentRange get_component_range() const;
+
+			// returns a view over the types of the components owned by this entity, without building a set
+			// (plain components and shared values are kept in storages and not part of the view)
+			ComponentTypeRange get_component_type_range() const;
+
 			// removes all components owned by this entity
 			void remove_all_components();
 
@@ -113,12 +172,30 @@ namespace tenjix {
 
 			Entity(World& world, Id id);
 
+			// returns the component map of this entity, which is kept by the cold store while this entity is cold
+			const ComponentMap& find_components() const;
+
 			/// template implementation details
 			void add(Type component_type, const shared<Component>& component);
 			void remove(Type component_type);
 			bool has(Type component_type) const;
 			shared<Component> get(Type component_type) const;
 
+			template <class ComponentType, typename... Arguments>
+			ComponentType& attach(std::false_type, Arguments&&... arguments);
+			template <class TagType>
+			TagType& attach(std::true_type);
+
+			template <class ComponentType>
+			void detach(std::false_type);
+			template <class TagType>
+			void detach(std::true_type);
+
+			template <class ComponentType>
+			bool holds(std::false_type) const;
+			template <class TagType>
+			bool holds(std::true_type) const;
+
 		};
 
 		using Entities = std::unordered_set<Entity>;
@@ -142,18 +219,26 @@ namespace tenjix {
 			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't add components");
 			Type type = typeid(ComponentType);
 			runtime_assert(not has(type), *this, " already contains a component of type ", type, ", can't add another");
+			ComponentRegistry::of<ComponentType>();
 			add(type, component);
 			return *component;
 		}
 
 		// adds a component of the given type to this entity, constructed with the given arguments
+		// (tags are only recorded in the type signature of this entity)
 		template <class ComponentType, typename... Arguments>
 		ComponentType& Entity::add(Arguments&&... arguments) {
-			static_assert(std::is_base_of<Component, ComponentType>(), "given type is not a component, can't add it to entity");
+			static_assert(std::is_base_of<Component, ComponentType>() or is_tag<ComponentType>(), "given type is not a component, can't add it to entity");
 			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't add components");
+			return attach<ComponentType>(is_tag<ComponentType>(), std::forward<Arguments>(arguments)...);
+		}
+
+		template <class ComponentType, typename... Arguments>
+		ComponentType& Entity::attach(std::false_type, Arguments&&... arguments) {
 			Type type = typeid(ComponentType);
 			runtime_assert(not has(type), *this, " already contains a component of type ", type, ", can't add another");
 			shared<ComponentType> component = std::make_shared<ComponentType>(std::forward<Arguments>(arguments)...);
+			ComponentRegistry::of<ComponentType>();
 			add(type, component);
 			return *component;
 		}
@@ -181,16 +266,26 @@ namespace tenjix {
 		// removes the component of the given type from this entity
 		template <class ComponentType>
 		void Entity::remove() {
-			static_assert(std::is_base_of<Component, ComponentType>(), "given type is not a component, can't remove it from entity");
+			static_assert(std::is_base_of<Component, ComponentType>() or is_tag<ComponentType>(), "given type is not a component, can't remove it from entity");
 			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't remove components");
+			detach<ComponentType>(is_tag<ComponentType>());
+		}
+
+		template <class ComponentType>
+		void Entity::detach(std::false_type) {
 			remove(typeid(ComponentType));
 		}
 
 		// checks whether this entity has a component of the given type
 		template <class ComponentType>
 		bool Entity::has() const {
-			static_assert(std::is_base_of<Component, ComponentType>(), "given type is not a component, can't determine if entity has it");
+			static_assert(std::is_base_of<Component, ComponentType>() or is_tag<ComponentType>(), "given type is not a component, can't determine if entity has it");
 			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't determine components");
+			return holds<ComponentType>(is_tag<ComponentType>());
+		}
+
+		template <class ComponentType>
+		bool Entity::holds(std::false_type) const {
 			return has(typeid(ComponentType));
 		}
 
@@ -199,8 +294,9 @@ namespace tenjix {
 		bool Entity::shares() const {
 			static_assert(std::is_base_of<Component, ComponentType>(), "given type is not a component, can't determine if entity has it");
 			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't determine shared components");
-			const shared<Component>& component = has(typeid(ComponentType));
-			return component and not component.unique();
+			shared<Component> component = get(typeid(ComponentType));
+			// the component map and the local copy hold one reference each
+			return component and component.use_count() > 2;
 		}
 
 		// returns the component of the given type owned by this entity
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+#include <ensys/Span.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// base of event channels, which get swapped by the world at the end of each update
+		class Channel {
+
+			friend class World;
+
+		public:
+
+			virtual ~Channel() noexcept {}
+
+		private:
+
+			// publishes the events emitted during the tick to readers
+			virtual void swap() = 0;
+
+		};
+
+		// a typed channel of events, emitted during one tick and readable as a contiguous span during the next tick
+		// each emitting thread appends to its own buffer, so systems running in parallel can emit without locking,
+		// all buffers keep their memory across ticks
+		template <class EventType>
+		class Events final : public Channel {
+
+		public:
+
+			// the maximum number of threads emitting into their own buffers at the same time,
+			// further threads emit into a shared buffer under a lock
+			static constexpr uint Max_Threads = 64;
+
+		private:
+
+			// the number of a thread, released when the thread exits so later threads reuse its buffer
+			struct ThreadNumber;
+
+			// the events of the last tick in emission order per thread
+			Lot<EventType> readable;
+
+			// the emit buffer of each thread number, installed on its first emit
+			std::atomic<Lot<EventType>*> emitted[Max_Threads] {};
+
+			// the buffer of the threads beyond the maximum number
+			Lot<EventType> overflow;
+			std::mutex overflow_mutex;
+
+		public:
+
+			Events() = default;
+
+			Events(const Events&) = delete;
+			Events& operator=(const Events&) = delete;
+
+			~Events() noexcept;
+
+			// emits an event constructed from the given arguments, may be called from any thread during the tick
+			template <typename... Arguments>
+			void emit(Arguments&&... arguments);
+
+			// returns the events emitted during the last tick
+			Span<const EventType> read() const;
+
+			// returns the number of events emitted during the last tick
+			uint size() const;
+
+			// drops all events, emitted and readable
+			void clear();
+
+		private:
+
+			// returns the dense number of the calling thread (or Max_Threads if all numbers are in use)
+			static uint thread_number();
+
+			// concatenates the emit buffers into the readable buffer, must not run concurrently with emits
+			void swap() override;
+
+		};
+
+		template <class EventType>
+		constexpr uint Events<EventType>::Max_Threads;
+
+		// takes the lowest free bit of the numbers in use and clears it again on thread exit
+		template <class EventType>
+		struct Events<EventType>::ThreadNumber {
+
+			static std::atomic<uint64_t> used;
+
+			uint number = Max_Threads;
+
+			ThreadNumber() {
+				uint64_t numbers = used.load();
+				while (~numbers != 0) {
+					uint free = 0;
+					while (numbers & (uint64_t(1) << free)) ++free;
+					if (used.compare_exchange_weak(numbers, numbers | (uint64_t(1) << free))) {
+						number = free;
+						break;
+					}
+				}
+			}
+
+			~ThreadNumber() {
+				if (number < Max_Threads) used.fetch_and(~(uint64_t(1) << number));
+			}
+
+		};
+
+		template <class EventType>
+		std::atomic<uint64_t> Events<EventType>::ThreadNumber::used(0);
+
+		template <class EventType>
+		Events<EventType>::~Events() noexcept {
+			for (auto& buffer : emitted) {
+				delete buffer.load();
+			}
+		}
+
+		// emits an event constructed from the given arguments, may be called from any thread during the tick
+		template <class EventType>
+		template <typename... Arguments>
+		void Events<EventType>::emit(Arguments&&... arguments) {
+			uint number = thread_number();
+			if (number == Max_Threads) {
+				std::lock_guard<std::mutex> lock(overflow_mutex);
+				overflow.emplace_back(std::forward<Arguments>(arguments)...);
+				return;
+			}
+			std::atomic<Lot<EventType>*>& slot = emitted[number];
+			Lot<EventType>* buffer = slot.load(std::memory_order_acquire);
+			if (buffer == nullptr) {
+				buffer = new Lot<EventType>();
+				slot.store(buffer, std::memory_order_release);
+			}
+			buffer->emplace_back(std::forward<Arguments>(arguments)...);
+		}
+
+		template <class EventType>
+		Span<const EventType> Events<EventType>::read() const {
+			return Span<const EventType>(readable.data(), readable.size());
+		}
+
+		template <class EventType>
+		uint Events<EventType>::size() const {
+			return readable.size();
+		}
+
+		template <class EventType>
+		void Events<EventType>::clear() {
+			readable.clear();
+			overflow.clear();
+			for (auto& slot : emitted) {
+				Lot<EventType>* buffer = slot.load();
+				if (buffer) buffer->clear();
+			}
+		}
+
+		// threads get their number on their first emit of this event type
+		template <class EventType>
+		uint Events<EventType>::thread_number() {
+			static_assert(Max_Threads <= 64, "the thread numbers in use are tracked in 64 bits");
+			thread_local ThreadNumber thread;
+			return thread.number;
+		}
+
+		template <class EventType>
+		void Events<EventType>::swap() {
+			readable.clear();
+			for (auto& slot : emitted) {
+				Lot<EventType>* buffer = slot.load(std::memory_order_acquire);
+				if (buffer == nullptr or buffer->empty()) continue;
+				readable.insert(readable.end(), std::make_move_iterator(buffer->begin()), std::make_move_iterator(buffer->end()));
+				buffer->clear();
+			}
+			readable.insert(readable.end(), std::make_move_iterator(overflow.begin()), std::make_move_iterator(overflow.end()));
+			overflow.clear();
+		}
+
+	}
+
+}
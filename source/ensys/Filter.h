@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+#include <ensys/Tags.h>
+
+#include <utilities/TypeFilter.h>
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// a type filter which also keeps its required and excluded types in identity order,
+		// so the world can recognize equal filters (the type filter of the utilities offers no equality and doesn't expose its types)
+		// tags are additionally kept as bit masks, so changing a tag only has to test the masks of each filter
+		class Filter final : public TypeFilter {
+
+			Lot<Type> required_types;
+			Lot<Type> excluded_types;
+
+			Tags::Mask required_tags = 0;
+			Tags::Mask excluded_tags = 0;
+
+			// the number of required and excluded types which aren't tags
+			uint number_of_components = 0;
+
+		public:
+
+			// requires the given types
+			template <class... ComponentTypes>
+			Filter& require();
+
+			// excludes the given types
+			template <class... ComponentTypes>
+			Filter& exclude();
+
+			// returns the required types in identity order
+			const Lot<Type>& get_required_types() const {
+				return required_types;
+			}
+
+			// returns the excluded types in identity order
+			const Lot<Type>& get_excluded_types() const {
+				return excluded_types;
+			}
+
+			// returns the bits of the required tags
+			Tags::Mask get_required_tags() const {
+				return required_tags;
+			}
+
+			// returns the bits of the excluded tags
+			Tags::Mask get_excluded_tags() const {
+				return excluded_tags;
+			}
+
+			// checks whether the given tags satisfy this filter, ignoring all other types
+			bool accepts_tags(Tags::Mask tags) const {
+				return (tags & required_tags) == required_tags and not (tags & excluded_tags);
+			}
+
+			// checks whether this filter requires or excludes types which aren't tags
+			bool has_components() const {
+				return number_of_components > 0;
+			}
+
+		private:
+
+			template <class ComponentType>
+			void insert(Lot<Type>& types, Tags::Mask& tags);
+
+			template <class ComponentType>
+			static Tags::Mask tag_of(std::true_type);
+			template <class ComponentType>
+			static Tags::Mask tag_of(std::false_type);
+
+		};
+
+		// requires the given types
+		template <class... ComponentTypes>
+		Filter& Filter::require() {
+			TypeFilter::require<ComponentTypes...>();
+			for_each_variadic(insert<ComponentTypes>(required_types, required_tags));
+			return *this;
+		}
+
+		// excludes the given types
+		template <class... ComponentTypes>
+		Filter& Filter::exclude() {
+			TypeFilter::exclude<ComponentTypes...>();
+			for_each_variadic(insert<ComponentTypes>(excluded_types, excluded_tags));
+			return *this;
+		}
+
+		template <class ComponentType>
+		void Filter::insert(Lot<Type>& types, Tags::Mask& tags) {
+			Type type = typeid(ComponentType);
+			auto position = std::lower_bound(types.begin(), types.end(), type);
+			if (position != types.end() and *position == type) return;
+			types.insert(position, type);
+			Tags::Mask tag = tag_of<ComponentType>(is_tag<ComponentType>());
+			tags |= tag;
+			if (not tag) ++number_of_components;
+		}
+
+		template <class ComponentType>
+		Tags::Mask Filter::tag_of(std::true_type) {
+			return Tags::bit_of<ComponentType>();
+		}
+
+		template <class ComponentType>
+		Tags::Mask Filter::tag_of(std::false_type) {
+			return 0;
+		}
+
+	}
+
+}
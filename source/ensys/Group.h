@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+
+#include <ensys/Entity.h>
+#include <ensys/Filter.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		class System;
+
+		// the entities accepted by a type filter, shared by all systems of a world with an equal filter
+		// (membership is stored and maintained once per distinct filter instead of once per system)
+		class Group final {
+
+		public:
+
+			// the sorted required and excluded types of a filter, identifying groups with equal filters
+			using Key = std::pair<Lot<Type>, Lot<Type>>;
+
+			// the canonical form of the filter, identifying groups with equal filters
+			const Key key;
+			// the filter accepting the entities of this group
+			const Filter filter;
+
+			// the entities accepted by the filter
+			Entities entities;
+			// the systems sharing this group
+			Lot<System*> systems;
+
+			Group(const Key& key, const Filter& filter) : key(key), filter(filter) {}
+
+			Group(const Group&) = delete;
+			Group(Group&&) = delete;
+
+			Group& operator=(const Group&) = delete;
+			Group& operator=(Group&&) = delete;
+
+			// returns the canonical form of the given filter (type names aren't unique, so types are compared by identity)
+			static Key key_of(const Filter& filter) {
+				return Key(filter.get_required_types(), filter.get_excluded_types());
+			}
+
+		};
+
+		using Groups = OrderedMap<Group::Key, unique<Group>>;
+
+	}
+
+}
@@ -0,0 +1,232 @@
+#include "Hierarchy.h"
+
+#include <algorithm>
+
+#include <ensys/IDs.h>
+
+#include <utilities/Assertions.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		void Hierarchy::attach(Entity::Id child, Entity::Id parent) {
+			runtime_assert(child != parent, "entity #", child, " can't be its own parent");
+			for (Entity::Id ancestor = get_parent(parent); ancestor != IDs::No_Id; ancestor = get_parent(ancestor)) {
+				runtime_assert(ancestor != child, "entity #", child, " is an ancestor of entity #", parent, ", can't attach it as child");
+			}
+			if (not contains(parent)) insert(Link { parent, IDs::No_Id }, 0);
+			uint depth = nodes.at(parent).depth + 1;
+			if (contains(child)) {
+				Entity::Id old_parent = get_parent(child);
+				if (old_parent == parent) return;
+				if (old_parent != IDs::No_Id) unlink(child, old_parent);
+				move(child, parent, depth);
+				if (old_parent != IDs::No_Id) prune(old_parent);
+			} else {
+				insert(Link { child, parent }, depth);
+			}
+			children[parent].push_back(child);
+		}
+
+		void Hierarchy::detach(Entity::Id child) {
+			Entity::Id parent = get_parent(child);
+			if (parent == IDs::No_Id) return;
+			unlink(child, parent);
+			move(child, IDs::No_Id, 0);
+			prune(parent);
+			prune(child);
+		}
+
+		Lot<Entity::Id> Hierarchy::remove(Entity::Id id) {
+			Lot<Entity::Id> subtree;
+			if (not contains(id)) return subtree;
+			collect(id, subtree);
+			Entity::Id parent = get_parent(id);
+			if (parent != IDs::No_Id) unlink(id, parent);
+			erase(subtree);
+			for (Entity::Id removed : subtree) {
+				children.erase(removed);
+			}
+			if (parent != IDs::No_Id) prune(parent);
+			return subtree;
+		}
+
+		bool Hierarchy::contains(Entity::Id id) const {
+			return nodes.find(id) != nodes.end();
+		}
+
+		Entity::Id Hierarchy::get_parent(Entity::Id id) const {
+			auto iterator = nodes.find(id);
+			if (iterator == nodes.end()) return IDs::No_Id;
+			return links[iterator->second.position].parent;
+		}
+
+		const Lot<Entity::Id>& Hierarchy::get_children(Entity::Id id) const {
+			static const Lot<Entity::Id> no_children;
+			auto iterator = children.find(id);
+			if (iterator == children.end()) return no_children;
+			return iterator->second;
+		}
+
+		uint Hierarchy::get_depth(Entity::Id id) const {
+			auto iterator = nodes.find(id);
+			if (iterator == nodes.end()) return 0;
+			return iterator->second.depth;
+		}
+
+		const Hierarchy::Links& Hierarchy::get_links() const {
+			return links;
+		}
+
+		uint Hierarchy::get_number_of_levels() const {
+			return level_ends.size();
+		}
+
+		void Hierarchy::clear() {
+			links.clear();
+			level_ends.clear();
+			nodes.clear();
+			children.clear();
+		}
+
+		void Hierarchy::renumber(Entity::Id from, Entity::Id to) {
+			auto node = nodes.find(from);
+			if (node == nodes.end()) return;
+			Link& link = links[node->second.position];
+			link.entity = to;
+			Node moved_node = node->second;
+			nodes.erase(node);
+			nodes.emplace(to, moved_node);
+			if (link.parent != IDs::No_Id) {
+				auto& siblings = children[link.parent];
+				*std::find(siblings.begin(), siblings.end(), from) = to;
+			}
+			auto own_children = children.find(from);
+			if (own_children == children.end()) return;
+			for (Entity::Id child : own_children->second) {
+				links[nodes.at(child).position].parent = to;
+			}
+			Lot<Entity::Id> moved = std::move(own_children->second);
+			children.erase(own_children);
+			children.emplace(to, std::move(moved));
+		}
+
+		void Hierarchy::shrink() {
+			links.shrink_to_fit();
+			nodes.rehash(0);
+			children.rehash(0);
+		}
+
+		// makes room at the end of the depth level by moving the first link of each deeper level to its levels end
+		// (costs one move per deeper level instead of shifting all following links)
+		void Hierarchy::insert(const Link& link, uint depth) {
+			if (depth == level_ends.size()) level_ends.push_back(links.size());
+			links.push_back(link);
+			uint hole = links.size() - 1;
+			for (uint level = level_ends.size() - 1; level > depth; --level) {
+				uint first = level_ends[level - 1];
+				if (first != hole) {
+					links[hole] = links[first];
+					nodes[links[hole].entity].position = hole;
+				}
+				hole = first;
+				level_ends[level]++;
+			}
+			links[hole] = link;
+			nodes[link.entity] = Node { hole, depth };
+			level_ends[depth]++;
+		}
+
+		// fills the hole with the last link of its level and moves the hole through all deeper levels to the end
+		void Hierarchy::erase(Entity::Id id) {
+			auto iterator = nodes.find(id);
+			Node node = iterator->second;
+			nodes.erase(iterator);
+			uint hole = node.position;
+			for (uint level = node.depth; level < level_ends.size(); ++level) {
+				uint last = level_ends[level] - 1;
+				if (last != hole) {
+					links[hole] = links[last];
+					nodes[links[hole].entity].position = hole;
+				}
+				hole = last;
+				level_ends[level]--;
+			}
+			links.pop_back();
+			while (not level_ends.empty() and level_ends.back() == (level_ends.size() > 1 ? level_ends[level_ends.size() - 2] : 0)) {
+				level_ends.pop_back();
+			}
+		}
+
+		void Hierarchy::erase(const Lot<Entity::Id>& ids) {
+			if (ids.size() == 1) {
+				erase(ids.front());
+				return;
+			}
+			for (Entity::Id id : ids) {
+				auto iterator = nodes.find(id);
+				links[iterator->second.position].entity = IDs::No_Id;
+				nodes.erase(iterator);
+			}
+			uint kept = 0;
+			std::fill(level_ends.begin(), level_ends.end(), 0);
+			for (uint position = 0; position < links.size(); ++position) {
+				const Link link = links[position];
+				if (link.entity == IDs::No_Id) continue;
+				Node& node = nodes[link.entity];
+				node.position = kept;
+				links[kept++] = link;
+				level_ends[node.depth] = kept;
+			}
+			links.resize(kept);
+			for (uint level = 1; level < level_ends.size(); ++level) {
+				if (level_ends[level] < level_ends[level - 1]) level_ends[level] = level_ends[level - 1];
+			}
+			while (not level_ends.empty() and level_ends.back() == (level_ends.size() > 1 ? level_ends[level_ends.size() - 2] : 0)) {
+				level_ends.pop_back();
+			}
+		}
+
+		void Hierarchy::move(Entity::Id id, Entity::Id parent, uint depth) {
+			Lot<Entity::Id> subtree;
+			collect(id, subtree);
+			Links moved;
+			moved.reserve(subtree.size());
+			for (Entity::Id entity : subtree) {
+				moved.push_back(links[nodes.at(entity).position]);
+			}
+			erase(subtree);
+			moved.front().parent = parent;
+			insert(moved.front(), depth);
+			for (uint i = 1; i < moved.size(); ++i) {
+				insert(moved[i], nodes.at(moved[i].parent).depth + 1);
+			}
+		}
+
+		void Hierarchy::unlink(Entity::Id child, Entity::Id parent) {
+			auto iterator = children.find(parent);
+			if (iterator == children.end()) return;
+			auto& siblings = iterator->second;
+			siblings.erase(std::find(siblings.begin(), siblings.end(), child));
+			if (siblings.empty()) children.erase(iterator);
+		}
+
+		void Hierarchy::prune(Entity::Id id) {
+			if (not contains(id)) return;
+			if (get_parent(id) != IDs::No_Id or children.find(id) != children.end()) return;
+			erase(id);
+		}
+
+		void Hierarchy::collect(Entity::Id id, Lot<Entity::Id>& subtree) const {
+			subtree.push_back(id);
+			for (uint i = 0; i < subtree.size(); ++i) {
+				auto iterator = children.find(subtree[i]);
+				if (iterator == children.end()) continue;
+				subtree.insert(subtree.end(), iterator->second.begin(), iterator->second.end());
+			}
+		}
+
+	}
+
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <ensys/Entity.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// stores parent child relations between entities
+		// the links are kept contiguously in breadth first (depth) order, so parents always precede their children
+		// and passes like transform propagation can run as a single linear sweep over get_links()
+		class Hierarchy final {
+
+		public:
+
+			struct Link {
+				// the id of the linked entity
+				Entity::Id entity;
+				// the id of the entities parent (or IDs::No_Id for roots)
+				Entity::Id parent;
+			};
+
+			using Links = Lot<Link>;
+
+		private:
+
+			struct Node {
+				uint position;
+				uint depth;
+			};
+
+			// the links ordered by depth
+			Links links;
+			// the exclusive end position of each depth level within the links
+			Lot<uint> level_ends;
+			// the position and depth of each linked entity
+			Map<Entity::Id, Node> nodes;
+			// the ids of the children of each parent
+			Map<Entity::Id, Lot<Entity::Id>> children;
+
+		public:
+
+			Hierarchy() = default;
+
+			Hierarchy(const Hierarchy&) = delete;
+			Hierarchy(Hierarchy&&) = delete;
+
+			Hierarchy& operator=(const Hierarchy&) = delete;
+			Hierarchy& operator=(Hierarchy&&) = delete;
+
+			// attaches the child to the given parent, moving the childs subtree to its new depth
+			void attach(Entity::Id child, Entity::Id parent);
+
+			// detaches the child from its parent, making it a root of its subtree
+			void detach(Entity::Id child);
+
+			// removes the entity with its whole subtree in one batch and returns the removed ids (in depth order)
+			Lot<Entity::Id> remove(Entity::Id id);
+
+			// checks whether the entity with the given id has a parent or children
+			bool contains(Entity::Id id) const;
+
+			// returns the id of the parent (or IDs::No_Id if there is none)
+			Entity::Id get_parent(Entity::Id id) const;
+
+			// returns the ids of the children
+			const Lot<Entity::Id>& get_children(Entity::Id id) const;
+
+			// returns the depth of the entity (roots have depth zero)
+			uint get_depth(Entity::Id id) const;
+
+			// returns all links ordered by depth (parents precede their children)
+			const Links& get_links() const;
+
+			// returns the number of depth levels
+			uint get_number_of_levels() const;
+
+			// removes all links
+			void clear();
+
+			// moves the links of the entity with the given id to another (unused) id
+			void renumber(Entity::Id from, Entity::Id to);
+
+			// releases memory kept from peak usage
+			void shrink();
+
+		private:
+
+			// inserts the link at the end of the given depth level
+			void insert(const Link& link, uint depth);
+			// erases the link of the given entity, keeping the depth order
+			void erase(Entity::Id id);
+			// erases the links of the given entities in a single pass, keeping the depth order
+			void erase(const Lot<Entity::Id>& ids);
+
+			// moves the subtree of the given entity to the given depth
+			void move(Entity::Id id, Entity::Id parent, uint depth);
+			// removes the entity from the children of its parent
+			void unlink(Entity::Id child, Entity::Id parent);
+			// removes the entity from the hierarchy if it has neither parent nor children
+			void prune(Entity::Id id);
+
+			// collects the ids of the subtree of the given entity in depth order
+			void collect(Entity::Id id, Lot<Entity::Id>& subtree) const;
+
+		};
+
+	}
+
+}
@@ -6,6 +6,8 @@ namespace tenjix {
 
 	namespace ensys {
 
+		constexpr uint IDs::No_Id;
+
 		IDs::IDs(uint initial_pool_size = 100) : ids(1 + initial_pool_size, false), next_id(1) {}
 
 		uint IDs::acquire() {
@@ -29,6 +31,21 @@ namespace tenjix {
 			return id;
 		}
 
+		// skipped ids become reusable, claiming ids in ascending order avoids searching them
+		void IDs::claim(uint id) {
+			if (id >= next_id) {
+				for (uint skipped = next_id; skipped < id and not withholding; ++skipped) {
+					reusable_ids.push_back(skipped);
+				}
+				next_id = id + 1;
+				if (ids.size() <= id) ids.resize(id + 1, false);
+			} else {
+				auto iterator = std::find(reusable_ids.begin(), reusable_ids.end(), id);
+				if (iterator != reusable_ids.end()) reusable_ids.erase(iterator);
+			}
+			ids[id] = true;
+		}
+
 		void IDs::require(uint number_of_new_ids) {
 			auto number_of_ids = count() + number_of_new_ids;
 			ids.reserve(number_of_ids);
@@ -37,7 +54,26 @@ namespace tenjix {
 		void IDs::release(uint id) {
 			if (not exists(id)) return;
 			ids[id] = false;
-			reusable_ids.push_back(id);
+			if (not withholding) reusable_ids.push_back(id);
+		}
+
+		void IDs::withhold() {
+			withholding = true;
+			reusable_ids.clear();
+		}
+
+		void IDs::rebuild() {
+			withholding = false;
+			uint last = ids.size() - 1;
+			while (last > 0 and not ids[last]) --last;
+			next_id = last + 1;
+			ids.resize(next_id);
+			ids.shrink_to_fit();
+			reusable_ids.clear();
+			for (uint id = last; id > 0; --id) {
+				if (not ids[id]) reusable_ids.push_back(id);
+			}
+			reusable_ids.shrink_to_fit();
 		}
 
 		bool IDs::exists(uint id) const {
@@ -50,6 +86,7 @@ namespace tenjix {
 
 		void IDs::clear() {
 			next_id = 1;
+			withholding = false;
 			reusable_ids.clear();
 			ids.resize(1);
 			ids.shrink_to_fit();
@@ -17,6 +17,9 @@ namespace tenjix {
 			// the list of all ids (true = existing id, false = reusable id)
 			Lot<bool> ids;
 
+			// released ids aren't reused until the next rebuild
+			bool withholding = false;
+
 		public:
 
 			static constexpr uint No_Id = 0;
@@ -32,12 +35,21 @@ namespace tenjix {
 			// acquires a new id
 			uint acquire();
 
+			// acquires the given id, which must not exist (e.g. when restoring persisted entities)
+			void claim(uint id);
+
 			// announces the number of required new ids
 			void require(uint number_of_new_ids);
 
 			// releases an id from the pool
 			void release(uint id);
 
+			// stops reusing ids until the next rebuild, so new ids are acquired above all existing ones
+			void withhold();
+
+			// rebuilds the reusable ids from the gaps between existing ids, the lowest gaps get reused first
+			void rebuild();
+
 			// checks whether this id is existing
 			bool exists(uint id) const;
 
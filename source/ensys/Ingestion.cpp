@@ -0,0 +1,69 @@
+#include "Ingestion.h"
+
+namespace tenjix {
+
+	namespace ensys {
+
+		Ingestion::~Ingestion() {
+			discard(head.exchange(nullptr, std::memory_order_acquire));
+		}
+
+		void Ingestion::create(StagedEntity&& entity) {
+			push(new Creation(std::move(entity)));
+		}
+
+		// takes the whole list at once and reverses it into queue order, producers keep pushing onto the emptied list meanwhile
+		uint Ingestion::drain(World& world) {
+			Ingested* operation = head.exchange(nullptr, std::memory_order_acquire);
+			Ingested* first = nullptr;
+			uint number_of_operations = 0;
+			while (operation) {
+				Ingested* next = operation->next;
+				operation->next = first;
+				first = operation;
+				operation = next;
+				number_of_operations++;
+			}
+			// owns the operations not applied yet, so they get deleted if applying one throws
+			struct Remaining {
+				Ingested* first;
+				~Remaining() {
+					discard(first);
+				}
+			} remaining { first };
+			while (remaining.first) {
+				unique<Ingested> applied(remaining.first);
+				remaining.first = applied->next;
+				applied->apply(world);
+			}
+			return number_of_operations;
+		}
+
+		void Ingestion::drain_at(World& world, System::UpdateStage stage) {
+			world.add_sync_point(stage, [this](World& world) {
+				drain(world);
+			});
+		}
+
+		bool Ingestion::is_empty() const {
+			return head.load(std::memory_order_relaxed) == nullptr;
+		}
+
+		void Ingestion::discard(Ingested* operation) {
+			while (operation) {
+				Ingested* next = operation->next;
+				delete operation;
+				operation = next;
+			}
+		}
+
+		void Ingestion::push(Ingested* operation) {
+			Ingested* next = head.load(std::memory_order_relaxed);
+			do {
+				operation->next = next;
+			} while (not head.compare_exchange_weak(next, operation, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+	}
+
+}
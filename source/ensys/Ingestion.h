@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+#include <ensys/Entity.h>
+#include <ensys/Partition.h>
+#include <ensys/System.h>
+#include <ensys/World.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// a lock free queue of entity creations and component assignments from any number of producer threads (e.g. network or io threads),
+		// drained in bulk by the thread updating the world, so producers never wait for the simulation and vice versa
+		class Ingestion final {
+
+			// a queued operation
+			struct Ingested {
+				Ingested* next = nullptr;
+				virtual ~Ingested() noexcept {}
+				virtual void apply(World& world) = 0;
+			};
+
+			struct Creation;
+
+			template <class ComponentType>
+			struct Assignment;
+
+			// the most recently queued operation, linking to the operations queued before
+			std::atomic<Ingested*> head { nullptr };
+
+		public:
+
+			Ingestion() = default;
+
+			Ingestion(const Ingestion&) = delete;
+			Ingestion& operator=(const Ingestion&) = delete;
+
+			// deletes the operations not drained
+			~Ingestion();
+
+			// queues the creation of an entity staged with its components, may be called from any thread
+			void create(StagedEntity&& entity);
+
+			// queues the assignment of a component value to the entity with the given id and generation (adding the component if necessary),
+			// may be called from any thread, the generation is read by the thread updating the world (World::get_generation) when the id
+			// is handed out, assignments to entities destroyed before draining are dropped, even if their id got reused meanwhile
+			template <class ComponentType>
+			void set(Entity::Id entity, uint generation, ComponentType&& value);
+
+			// applies all operations queued so far to the world in the order they were queued, returns their number
+			// (to be called by the thread updating the world)
+			uint drain(World& world);
+
+			// drains this queue at the sync point after the given stage of each update of the world
+			// (this queue has to outlive the world or its next clear)
+			void drain_at(World& world, System::UpdateStage stage);
+
+			// checks whether there are queued operations
+			bool is_empty() const;
+
+		private:
+
+			// prepends the operation, retrying if another producer prepended concurrently
+			void push(Ingested* operation);
+
+			// deletes the given operation and the operations linked to it
+			static void discard(Ingested* operation);
+
+		};
+
+		struct Ingestion::Creation final : Ingested {
+
+			StagedEntity entity;
+
+			explicit Creation(StagedEntity&& entity) : entity(std::move(entity)) {}
+
+			void apply(World& world) override {
+				world.create_entity(std::move(entity));
+			}
+
+		};
+
+		template <class ComponentType>
+		struct Ingestion::Assignment final : Ingested {
+
+			Entity::Id id;
+			uint generation;
+			ComponentType value;
+
+			Assignment(Entity::Id id, uint generation, ComponentType&& value) : id(id), generation(generation), value(std::move(value)) {}
+
+			void apply(World& world) override {
+				if (not world.is_existing(id) or world.get_generation(id) != generation) return;
+				Entity entity = world.get_entity(id);
+				if (entity.has<ComponentType>()) entity.get<ComponentType>() = std::move(value);
+				else entity.add<ComponentType>(std::move(value));
+			}
+
+		};
+
+		// queues the assignment of a component value to the entity with the given id (adding the component if necessary)
+		template <class ComponentType>
+		void Ingestion::set(Entity::Id entity, uint generation, ComponentType&& value) {
+			using Value = typename std::decay<ComponentType>::type;
+			static_assert(std::is_base_of<Component, Value>(), "given type is not a component, can't queue its assignment");
+			push(new Assignment<Value>(entity, generation, Value(std::forward<ComponentType>(value))));
+		}
+
+	}
+
+}
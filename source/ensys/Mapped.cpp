@@ -0,0 +1,195 @@
+#include "Mapped.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+	#define NOMINMAX
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include <utilities/Assertions.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		namespace {
+
+			const char Magic[4] = { 'E', 'C', 'H', 'K' };
+			const uint32_t Version = 1;
+
+		}
+
+#ifdef _WIN32
+
+		// windows extends the file to the full capacity when creating the mapping
+		MappedChunkAllocator::MappedChunkAllocator(const String& path, size_t capacity) : path(path), capacity(capacity) {
+			SYSTEM_INFO system_info;
+			GetSystemInfo(&system_info);
+			page_size = system_info.dwAllocationGranularity;
+			runtime_assert(capacity > page_size, "the capacity of mapped chunks has to exceed one page");
+			file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			runtime_assert(file != INVALID_HANDLE_VALUE, "can't open chunk file \"", path, "\"");
+			file_mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(uint64_t(capacity) >> 32), static_cast<DWORD>(capacity), nullptr);
+			runtime_assert(file_mapping != nullptr, "can't map chunk file \"", path, "\"");
+			mapping = static_cast<char*>(MapViewOfFile(file_mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity));
+			runtime_assert(mapping != nullptr, "can't map chunk file \"", path, "\"");
+			file_size = capacity;
+			header = reinterpret_cast<Header*>(mapping);
+			if (std::memcmp(header->magic, Magic, sizeof(Magic)) != 0) {
+				std::memcpy(header->magic, Magic, sizeof(Magic));
+				header->version = Version;
+				header->chunk_size = 0;
+				header->number_of_chunks = 0;
+			}
+			runtime_assert(header->version == Version, "chunk file \"", path, "\" has the unsupported version ", header->version);
+		}
+
+		MappedChunkAllocator::~MappedChunkAllocator() noexcept {
+			flush();
+			UnmapViewOfFile(mapping);
+			CloseHandle(file_mapping);
+			CloseHandle(file);
+		}
+
+		void MappedChunkAllocator::prefetch(void* chunk, size_t size) {
+			WIN32_MEMORY_RANGE_ENTRY range;
+			char* begin;
+			page_range(chunk, size, begin, range.NumberOfBytes);
+			range.VirtualAddress = begin;
+			PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+		}
+
+		// unlocking pages which aren't locked removes them from the working set
+		void MappedChunkAllocator::evict(void* chunk, size_t size) {
+			char* begin;
+			size_t length;
+			page_range(chunk, size, begin, length);
+			FlushViewOfFile(begin, length);
+			VirtualUnlock(begin, length);
+		}
+
+		void MappedChunkAllocator::flush() {
+			FlushViewOfFile(mapping, 0);
+			FlushFileBuffers(file);
+		}
+
+		void MappedChunkAllocator::extend(size_t size) {
+			runtime_assert(size <= file_size, "chunk file \"", path, "\" exceeds its capacity of ", capacity, " bytes");
+		}
+
+#else
+
+		// reserves the whole capacity, but only extends the file as chunks get allocated
+		MappedChunkAllocator::MappedChunkAllocator(const String& path, size_t capacity) : path(path), capacity(capacity) {
+			page_size = sysconf(_SC_PAGESIZE);
+			runtime_assert(capacity > page_size, "the capacity of mapped chunks has to exceed one page");
+			file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+			runtime_assert(file >= 0, "can't open chunk file \"", path, "\"");
+			struct stat status;
+			fstat(file, &status);
+			file_size = status.st_size;
+			void* address = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+			runtime_assert(address != MAP_FAILED, "can't map chunk file \"", path, "\"");
+			mapping = static_cast<char*>(address);
+			header = reinterpret_cast<Header*>(mapping);
+			if (file_size < page_size) {
+				extend(page_size);
+				std::memcpy(header->magic, Magic, sizeof(Magic));
+				header->version = Version;
+				header->chunk_size = 0;
+				header->number_of_chunks = 0;
+			}
+			runtime_assert(std::memcmp(header->magic, Magic, sizeof(Magic)) == 0, "\"", path, "\" isn't a chunk file");
+			runtime_assert(header->version == Version, "chunk file \"", path, "\" has the unsupported version ", header->version);
+		}
+
+		MappedChunkAllocator::~MappedChunkAllocator() noexcept {
+			flush();
+			munmap(mapping, capacity);
+			close(file);
+		}
+
+		void MappedChunkAllocator::prefetch(void* chunk, size_t size) {
+			char* begin;
+			size_t length;
+			page_range(chunk, size, begin, length);
+			madvise(begin, length, MADV_WILLNEED);
+		}
+
+		// dropping pages of a shared mapping keeps their contents in the file
+		void MappedChunkAllocator::evict(void* chunk, size_t size) {
+			char* begin;
+			size_t length;
+			page_range(chunk, size, begin, length);
+			msync(begin, length, MS_ASYNC);
+			madvise(begin, length, MADV_DONTNEED);
+		}
+
+		void MappedChunkAllocator::flush() {
+			msync(mapping, file_size, MS_SYNC);
+		}
+
+		void MappedChunkAllocator::extend(size_t size) {
+			if (size <= file_size) return;
+			runtime_assert(size <= capacity, "chunk file \"", path, "\" exceeds its capacity of ", capacity, " bytes");
+			runtime_assert(ftruncate(file, size) == 0, "can't extend chunk file \"", path, "\"");
+			file_size = size;
+		}
+
+#endif
+
+		void* MappedChunkAllocator::allocate(size_t size, size_t alignment) {
+			runtime_assert(page_size % alignment == 0 and size % alignment == 0, "mapped chunks can't be aligned to ", alignment, " bytes");
+			runtime_assert(header->chunk_size == 0 or header->chunk_size == size, "chunk file \"", path, "\" holds chunks of ", header->chunk_size, " bytes, can't allocate ", size);
+			header->chunk_size = size;
+			extend(page_size + (header->number_of_chunks + 1) * size);
+			return chunk_at(header->number_of_chunks++);
+		}
+
+		void MappedChunkAllocator::deallocate(void* chunk, size_t size) {
+			runtime_assert(header->number_of_chunks > 0 and chunk == chunk_at(header->number_of_chunks - 1), "mapped chunks have to be released in reverse allocation order");
+			header->number_of_chunks--;
+		}
+
+		uint MappedChunkAllocator::restore(size_t size, Lot<void*>& chunks) {
+			if (header->number_of_chunks == 0) return 0;
+			runtime_assert(header->chunk_size == size, "chunk file \"", path, "\" holds chunks of ", header->chunk_size, " bytes, can't restore chunks of ", size);
+			for (uint64_t index = 0; index < header->number_of_chunks; ++index) {
+				chunks.push_back(chunk_at(index));
+			}
+			return header->number_of_chunks;
+		}
+
+		bool MappedChunkAllocator::is_persistent() const {
+			return true;
+		}
+
+		uint MappedChunkAllocator::get_number_of_chunks() const {
+			return header->number_of_chunks;
+		}
+
+		const String& MappedChunkAllocator::get_path() const {
+			return path;
+		}
+
+		void* MappedChunkAllocator::chunk_at(uint64_t index) const {
+			return mapping + page_size + index * header->chunk_size;
+		}
+
+		void MappedChunkAllocator::page_range(void* address, size_t size, char*& begin, size_t& length) const {
+			size_t first = reinterpret_cast<size_t>(address) / page_size * page_size;
+			size_t last = (reinterpret_cast<size_t>(address) + size + page_size - 1) / page_size * page_size;
+			begin = reinterpret_cast<char*>(first);
+			length = last - first;
+		}
+
+	}
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+
+#include <ensys/Table.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// allocates the chunks of one table in a memory mapped file, so the operating system pages cold chunks out
+		// and the rows persist across sessions: a table constructed with an allocator of the same file restores them
+		// chunks are handed out like a stack and have to be released in reverse allocation order (as tables do)
+		class MappedChunkAllocator final : public ChunkAllocator {
+
+			// the first page of the file
+			struct Header {
+				char magic[4];
+				uint32_t version;
+				uint64_t chunk_size;
+				uint64_t number_of_chunks;
+			};
+
+			const String path;
+			// the number of bytes reserved for the mapping (including the header page)
+			const size_t capacity;
+
+			size_t page_size;
+
+			// the size the file is currently extended to
+			size_t file_size = 0;
+
+			char* mapping = nullptr;
+			Header* header = nullptr;
+
+#ifdef _WIN32
+			void* file = nullptr;
+			void* file_mapping = nullptr;
+#else
+			int file = -1;
+#endif
+
+		public:
+
+			// opens or creates the file at the given path and reserves the given number of bytes of address space for it
+			MappedChunkAllocator(const String& path, size_t capacity);
+
+			MappedChunkAllocator(const MappedChunkAllocator&) = delete;
+			MappedChunkAllocator& operator=(const MappedChunkAllocator&) = delete;
+
+			// flushes and unmaps the file
+			~MappedChunkAllocator() noexcept;
+
+			void* allocate(size_t size, size_t alignment) override;
+			void deallocate(void* chunk, size_t size) override;
+
+			uint restore(size_t size, Lot<void*>& chunks) override;
+
+			bool is_persistent() const override;
+
+			// advises the operating system to read the pages of the chunk ahead
+			void prefetch(void* chunk, size_t size) override;
+
+			// writes the pages of the chunk back and drops them from the resident set
+			void evict(void* chunk, size_t size) override;
+
+			// writes all modified pages back to the file
+			void flush();
+
+			// returns the number of allocated chunks
+			uint get_number_of_chunks() const;
+
+			// returns the path of the mapped file
+			const String& get_path() const;
+
+		private:
+
+			void* chunk_at(uint64_t index) const;
+
+			// extends the file to cover at least the given size
+			void extend(size_t size);
+
+			// returns the page aligned range covering the given range
+			void page_range(void* address, size_t size, char*& begin, size_t& length) const;
+
+		};
+
+	}
+
+}
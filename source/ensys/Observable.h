@@ -13,6 +13,17 @@ namespace tenjix {
 
 		public:
 
+			ObservableComponent() = default;
+
+			// copies don't inherit the observers, the systems attach to the entity of the copy themselves
+			ObservableComponent(const ObservableComponent& other) : Component(other) {}
+
+			// assigned components keep their own observers
+			ObservableComponent& operator=(const ObservableComponent& other) {
+				Component::operator=(other);
+				return *this;
+			}
+
 			void attach(System* observer, const Entity& entity) {
 				observers[observer].insert(entity);
 				//auto& entities = observers[observer];
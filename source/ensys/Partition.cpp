@@ -0,0 +1,116 @@
+#include "Partition.h"
+
+namespace tenjix {
+
+	namespace ensys {
+
+		void Cells::assign(Entity::Id entity, Id cell) {
+			release(entity);
+			cells.emplace(entity, cell);
+			members[cell].insert(entity);
+		}
+
+		Cells::Id Cells::get_cell(Entity::Id entity) const {
+			auto iterator = cells.find(entity);
+			runtime_assert(iterator != cells.end(), "entity #", entity, " isn't tagged with a cell");
+			return iterator->second;
+		}
+
+		const Set<Entity::Id>& Cells::get_entities(Id cell) const {
+			static const Set<Entity::Id> no_entities;
+			auto iterator = members.find(cell);
+			return iterator == members.end() ? no_entities : iterator->second;
+		}
+
+		bool Cells::has_cell(Id cell) const {
+			return members.find(cell) != members.end();
+		}
+
+		uint Cells::get_number_of_cells() const {
+			return members.size();
+		}
+
+		bool Cells::contains(Entity::Id entity) const {
+			return cells.find(entity) != cells.end();
+		}
+
+		// cells are no component types, so they don't take part in system filters
+		void Cells::collect(Entity::Id entity, Types& types) const {}
+
+		void Cells::release(Entity::Id entity) {
+			auto iterator = cells.find(entity);
+			if (iterator == cells.end()) return;
+			auto cell = members.find(iterator->second);
+			cell->second.erase(entity);
+			if (cell->second.empty()) members.erase(cell);
+			cells.erase(iterator);
+		}
+
+		void Cells::clear() {
+			cells.clear();
+			members.clear();
+		}
+
+		void Cells::renumber(Entity::Id from, Entity::Id to) {
+			auto iterator = cells.find(from);
+			if (iterator == cells.end()) return;
+			Id cell = iterator->second;
+			cells.erase(iterator);
+			cells.emplace(to, cell);
+			auto& entities = members[cell];
+			entities.erase(from);
+			entities.insert(to);
+		}
+
+		void Cells::shrink() {
+			cells.rehash(0);
+			for (auto& entry : members) {
+				entry.second.rehash(0);
+			}
+		}
+
+		StagedEntity::StagedEntity(const String& name) : name(name) {}
+
+		const Types& StagedEntity::get_component_types() const {
+			return types;
+		}
+
+		StagedCell::StagedCell(Cells::Id cell) : cell(cell) {}
+
+		StagedEntity& StagedCell::create_entity(const String& name) {
+			entities.emplace_back(name);
+			return entities.back();
+		}
+
+		void StagedCell::reserve(uint number_of_entities) {
+			entities.reserve(number_of_entities);
+		}
+
+		Cells::Id StagedCell::get_cell() const {
+			return cell;
+		}
+
+		uint StagedCell::get_number_of_entities() const {
+			return entities.size();
+		}
+
+		void Staging::stage(StagedCell&& cell) {
+			std::lock_guard<std::mutex> lock(mutex);
+			cells.push_back(std::move(cell));
+		}
+
+		Lot<StagedCell> Staging::take() {
+			std::lock_guard<std::mutex> lock(mutex);
+			Lot<StagedCell> taken;
+			taken.swap(cells);
+			return taken;
+		}
+
+		uint Staging::get_number_of_cells() const {
+			std::lock_guard<std::mutex> lock(mutex);
+			return cells.size();
+		}
+
+	}
+
+}
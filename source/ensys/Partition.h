@@ -0,0 +1,140 @@
+#pragma once
+
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include <ensys/Component.h>
+#include <ensys/Entity.h>
+#include <ensys/Storage.h>
+
+#include <utilities/Assertions.h>
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// the cell (world partition, e.g. a map region) each entity is tagged with
+		class Cells final : public Storage {
+
+		public:
+
+			using Id = uint;
+
+		private:
+
+			Map<Entity::Id, Id> cells;
+			Map<Id, Set<Entity::Id>> members;
+
+		public:
+
+			// tags the entity with the given id with the given cell, replacing its former cell
+			void assign(Entity::Id entity, Id cell);
+
+			// returns the cell of the entity with the given id
+			Id get_cell(Entity::Id entity) const;
+
+			// returns the ids of the entities tagged with the given cell
+			const Set<Entity::Id>& get_entities(Id cell) const;
+
+			// checks whether there are entities tagged with the given cell
+			bool has_cell(Id cell) const;
+
+			// returns the number of cells with tagged entities
+			uint get_number_of_cells() const;
+
+			bool contains(Entity::Id entity) const override;
+			void collect(Entity::Id entity, Types& types) const override;
+			void release(Entity::Id entity) override;
+			void clear() override;
+			void renumber(Entity::Id from, Entity::Id to) override;
+			void shrink() override;
+
+		};
+
+		// an entity staged for a commit to a world, with its components already constructed
+		class StagedEntity final {
+
+			friend class World;
+
+			String name;
+
+			Lot<std::pair<Type, shared<Component>>> components;
+
+			Types types;
+
+		public:
+
+			explicit StagedEntity(const String& name = "");
+
+			// adds a component of the given type, constructed with the given arguments
+			template <class ComponentType, typename... Arguments>
+			StagedEntity& add(Arguments&&... arguments);
+
+			// returns the types of the components of this entity
+			const Types& get_component_types() const;
+
+		};
+
+		// the entities of a cell constructed apart from the world (e.g. while deserializing on a background thread),
+		// which get spliced into the world in one commit
+		// staging touches no world state and components only record to per thread trace buffers,
+		// so cells can be staged on any thread as long as their component types are constructible there
+		class StagedCell final {
+
+			friend class World;
+
+			Cells::Id cell;
+
+			Lot<StagedEntity> entities;
+
+		public:
+
+			explicit StagedCell(Cells::Id cell);
+
+			// stages a new entity with the given name
+			StagedEntity& create_entity(const String& name = "");
+
+			// reserves memory for the given number of entities
+			void reserve(uint number_of_entities);
+
+			Cells::Id get_cell() const;
+
+			uint get_number_of_entities() const;
+
+		};
+
+		// hands staged cells from background threads over to the thread updating the world
+		class Staging final {
+
+			mutable std::mutex mutex;
+
+			Lot<StagedCell> cells;
+
+		public:
+
+			// adds a completely staged cell, may be called from any thread
+			void stage(StagedCell&& cell);
+
+			// takes all staged cells, may be called from any thread
+			Lot<StagedCell> take();
+
+			// returns the number of staged cells waiting for a commit
+			uint get_number_of_cells() const;
+
+		};
+
+		// adds a component of the given type, constructed with the given arguments
+		template <class ComponentType, typename... Arguments>
+		StagedEntity& StagedEntity::add(Arguments&&... arguments) {
+			static_assert(std::is_base_of<Component, ComponentType>(), "given type is not a component, can't stage it");
+			Type type = typeid(ComponentType);
+			runtime_assert(types.insert(type).second, "staged entity already contains a component of type ", type, ", can't add another");
+			components.emplace_back(type, std::make_shared<ComponentType>(std::forward<Arguments>(arguments)...));
+			return *this;
+		}
+
+	}
+
+}
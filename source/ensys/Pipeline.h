@@ -0,0 +1,146 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+
+#include <ensys/System.h>
+#include <ensys/Table.h>
+#include <ensys/World.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// the plain component types a stage accesses
+		template <class... ComponentTypes>
+		struct StageAccess {};
+
+		// determines the accessed component types from the signature of the stages call operator
+		template <class Stage>
+		struct StageTraits : StageTraits<decltype(&Stage::operator())> {};
+
+		template <class Stage, class... Arguments>
+		struct StageTraits<void (Stage::*)(float, Arguments...)> {
+			using Access = StageAccess<typename std::decay<Arguments>::type...>;
+		};
+
+		template <class Stage, class... Arguments>
+		struct StageTraits<void (Stage::*)(float, Arguments...) const> {
+			using Access = StageAccess<typename std::decay<Arguments>::type...>;
+		};
+
+		template <class TableType, class... Stages>
+		class Pipeline;
+
+		// a system running a fixed sequence of stages over the rows of a table, resolved at compile time
+		// each stage is a type with a call operator taking the delta time followed by references to the plain components
+		// it accesses, e.g. void operator()(float delta_time, Position& position, const Velocity& velocity),
+		// the stages are invoked directly (without virtual dispatch) chunk by chunk, so the compiler can inline them
+		// and the pipeline itself takes part in the world update like any other (dynamically added) system
+		// (rows of entities which aren't members of the pipeline, e.g. deactivated ones, are skipped like in other systems)
+		template <class... ComponentTypes, class... Stages>
+		class Pipeline<Table<ComponentTypes...>, Stages...> final : public System {
+
+			static_assert(sizeof...(Stages) > 0, "a pipeline needs at least one stage");
+
+			using Columns = std::tuple<ComponentTypes*...>;
+
+			std::tuple<Stages...> stages;
+
+			// the membership flag of each entity by id
+			Lot<unsigned char> members;
+
+		public:
+
+			explicit Pipeline(Priority priority = 0, UpdateStage stage = UpdateStage::Update);
+
+			Pipeline(Priority priority, Stages... stages);
+
+			Pipeline(Priority priority, UpdateStage stage, Stages... stages);
+
+			// returns the stage of the given type
+			template <class Stage>
+			Stage& get_stage();
+
+		private:
+
+			void update(float delta_time) override;
+
+			void on_entity_added(const Entity& entity) override;
+			void on_entity_removed(const Entity& entity) override;
+
+			template <class Stage>
+			static void run(Stage& stage, Span<const unsigned char> disabled, const Lot<unsigned char>& members, Span<const Entity::Id> ids, const Columns& columns, float delta_time);
+
+			template <class Stage, class... AccessedTypes>
+			static void run(Stage& stage, Span<const unsigned char> disabled, const Lot<unsigned char>& members, Span<const Entity::Id> ids, const Columns& columns, float delta_time, StageAccess<AccessedTypes...>);
+
+		};
+
+		template <class... ComponentTypes, class... Stages>
+		Pipeline<Table<ComponentTypes...>, Stages...>::Pipeline(Priority priority, UpdateStage stage) : Pipeline(priority, stage, Stages()...) {}
+
+		template <class... ComponentTypes, class... Stages>
+		Pipeline<Table<ComponentTypes...>, Stages...>::Pipeline(Priority priority, Stages... stages) : Pipeline(priority, UpdateStage::Update, stages...) {}
+
+		template <class... ComponentTypes, class... Stages>
+		Pipeline<Table<ComponentTypes...>, Stages...>::Pipeline(Priority priority, UpdateStage stage, Stages... stages) : System(priority, stage), stages(stages...) {
+			filter.require<ComponentTypes...>();
+		}
+
+		template <class... ComponentTypes, class... Stages>
+		template <class Stage>
+		Stage& Pipeline<Table<ComponentTypes...>, Stages...>::get_stage() {
+			return std::get<Stage>(stages);
+		}
+
+		// runs the stages one after another on each chunk, while the chunk is in cache
+		template <class... ComponentTypes, class... Stages>
+		void Pipeline<Table<ComponentTypes...>, Stages...>::update(float delta_time) {
+			auto& stages = this->stages;
+			auto& members = this->members;
+			World& world = *this->world;
+			Span<const unsigned char> disabled = world.get_disabled_flags();
+			world.template table<ComponentTypes...>().for_each_chunk([&stages, &members, disabled, delta_time](Span<const Entity::Id> ids, Span<ComponentTypes>... components) {
+				Columns columns(components.data()...);
+				for_each_variadic(run(std::get<Stages>(stages), disabled, members, ids, columns, delta_time));
+			});
+		}
+
+		template <class... ComponentTypes, class... Stages>
+		void Pipeline<Table<ComponentTypes...>, Stages...>::on_entity_added(const Entity& entity) {
+			if (entity.id >= members.size()) members.resize(entity.id + 1, 0);
+			members[entity.id] = 1;
+		}
+
+		template <class... ComponentTypes, class... Stages>
+		void Pipeline<Table<ComponentTypes...>, Stages...>::on_entity_removed(const Entity& entity) {
+			if (entity.id < members.size()) members[entity.id] = 0;
+		}
+
+		template <class... ComponentTypes, class... Stages>
+		template <class Stage>
+		void Pipeline<Table<ComponentTypes...>, Stages...>::run(Stage& stage, Span<const unsigned char> disabled, const Lot<unsigned char>& members, Span<const Entity::Id> ids, const Columns& columns, float delta_time) {
+			run(stage, disabled, members, ids, columns, delta_time, typename StageTraits<Stage>::Access());
+		}
+
+		// skips rows of entities which aren't members (e.g. deactivated ones) and disabled entities,
+		// testing both flags inline so the loop stays free of calls besides the (inlined) stage
+		template <class... ComponentTypes, class... Stages>
+		template <class Stage, class... AccessedTypes>
+		void Pipeline<Table<ComponentTypes...>, Stages...>::run(Stage& stage, Span<const unsigned char> disabled, const Lot<unsigned char>& members, Span<const Entity::Id> ids, const Columns& columns, float delta_time, StageAccess<AccessedTypes...>) {
+			const unsigned char* member_flags = members.data();
+			uint number_of_members = members.size();
+			for (uint i = 0; i < ids.size(); ++i) {
+				Entity::Id id = ids[i];
+				bool member = id < number_of_members and member_flags[id];
+				bool enabled = id >= disabled.size() or not disabled[id];
+				if (member and enabled) stage(delta_time, std::get<AccessedTypes*>(columns)[i]...);
+			}
+		}
+
+	}
+
+}
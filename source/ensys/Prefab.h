@@ -0,0 +1,159 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include <ensys/Component.h>
+#include <ensys/Entity.h>
+#include <ensys/Registry.h>
+
+#include <utilities/Assertions.h>
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// a component value used as template for instantiating components in bulk
+		class Prototype {
+
+		public:
+
+			// the type of the prototyped component
+			const Type type;
+
+			explicit Prototype(Type type) : type(type) {}
+
+			Prototype(const Prototype&) = delete;
+			Prototype(Prototype&&) = delete;
+
+			Prototype& operator=(const Prototype&) = delete;
+			Prototype& operator=(Prototype&&) = delete;
+
+			virtual ~Prototype() noexcept {}
+
+			// appends the given number of copies of the prototyped component to the given components
+			virtual void instantiate(uint amount, Lot<shared<Component>>& components) const = 0;
+
+		};
+
+		// holds a component value which gets copied into the components of the instances
+		template <class ComponentType>
+		class ComponentPrototype final : public Prototype {
+
+		public:
+
+			const ComponentType value;
+
+			template <typename... Arguments>
+			explicit ComponentPrototype(Arguments&&... arguments) : Prototype(typeid(ComponentType)), value(std::forward<Arguments>(arguments)...) {}
+
+			// copies the value into one component per instance
+			void instantiate(uint amount, Lot<shared<Component>>& components) const override {
+				ComponentRegistry::of<ComponentType>().replicate(value, amount, components);
+			}
+
+		};
+
+		// holds a copy of a component of a type only known at runtime, replicated through the component registry
+		class ClonedPrototype final : public Prototype {
+
+		public:
+
+			const ComponentInfo& info;
+
+			const shared<const Component> value;
+
+			ClonedPrototype(const ComponentInfo& info, const shared<const Component>& value) : Prototype(info.type), info(info), value(value) {}
+
+			void instantiate(uint amount, Lot<shared<Component>>& components) const override {
+				info.replicate(*value, amount, components);
+			}
+
+		};
+
+		// describes a configured entity, which can be instantiated many times by the world
+		// the prefab resolves its system membership once per instantiation instead of once per entity
+		class Prefab final {
+
+			friend class World;
+
+			Lot<shared<const Prototype>> prototypes;
+
+			Types types;
+
+		public:
+
+			// adds a component of the given type, constructed with the given arguments
+			template <class ComponentType, typename... Arguments>
+			Prefab& add(Arguments&&... arguments);
+
+			// copies the components of the given types from the given template entity
+			template <class... ComponentTypes>
+			Prefab& copy(const Entity& entity);
+
+			// copies all components of the given template entity, using the registered metadata of their types
+			Prefab& copy_all(const Entity& entity);
+
+			// checks whether this prefab has a component of the given type
+			template <class ComponentType>
+			bool has() const;
+
+			// returns the types of the components of this prefab
+			const Types& get_component_types() const;
+
+			// returns the number of components of this prefab
+			uint get_number_of_components() const;
+
+		};
+
+		// adds a component of the given type, constructed with the given arguments
+		template <class ComponentType, typename... Arguments>
+		Prefab& Prefab::add(Arguments&&... arguments) {
+			static_assert(std::is_base_of<Component, ComponentType>(), "given type is not a component, can't add it to prefab");
+			static_assert(std::is_copy_constructible<ComponentType>(), "given component type isn't copy constructible, can't add it to prefab");
+			Type type = typeid(ComponentType);
+			runtime_assert(types.insert(type).second, "prefab already contains a component of type ", type, ", can't add another");
+			prototypes.push_back(std::make_shared<ComponentPrototype<ComponentType>>(std::forward<Arguments>(arguments)...));
+			return *this;
+		}
+
+		// copies the components of the given types from the given template entity
+		template <class... ComponentTypes>
+		Prefab& Prefab::copy(const Entity& entity) {
+			for_each_variadic(add<ComponentTypes>(entity.get<ComponentTypes>()));
+			return *this;
+		}
+
+		// checks whether this prefab has a component of the given type
+		template <class ComponentType>
+		bool Prefab::has() const {
+			return types.find(typeid(ComponentType)) != types.end();
+		}
+
+		inline Prefab& Prefab::copy_all(const Entity& entity) {
+			auto component_types = entity.get_component_type_range();
+			auto next_type = component_types.begin();
+			for (auto& component : entity.get_component_range()) {
+				Type type = *next_type++;
+				const ComponentInfo* info = ComponentRegistry::find(type);
+				runtime_assert(info and info->replicate, "components of type ", type, " can't be copied into a prefab");
+				runtime_assert(types.insert(type).second, "prefab already contains a component of type ", type, ", can't add another");
+				Lot<shared<Component>> copy;
+				info->replicate(*component, 1, copy);
+				prototypes.push_back(std::make_shared<ClonedPrototype>(*info, copy.front()));
+			}
+			return *this;
+		}
+
+		inline const Types& Prefab::get_component_types() const {
+			return types;
+		}
+
+		inline uint Prefab::get_number_of_components() const {
+			return prototypes.size();
+		}
+
+	}
+
+}
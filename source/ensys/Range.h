@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// projects a map entry onto its key
+		struct KeyProjection {
+			template <class Entry>
+			const typename Entry::first_type& operator()(const Entry& entry) const {
+				return entry.first;
+			}
+		};
+
+		// projects a map entry onto its value
+		struct ValueProjection {
+			template <class Entry>
+			const typename Entry::second_type& operator()(const Entry& entry) const {
+				return entry.second;
+			}
+		};
+
+		// a read only view over the projected elements of a container, iterating it without copying
+		template <class Iterator, class Projection>
+		class Range final {
+
+		public:
+
+			class iterator {
+
+				Iterator position;
+
+			public:
+
+				using iterator_category = std::forward_iterator_tag;
+				using reference = decltype(Projection()(*std::declval<Iterator>()));
+				using value_type = typename std::decay<reference>::type;
+				using pointer = const value_type*;
+				using difference_type = std::ptrdiff_t;
+
+				explicit iterator(Iterator position) : position(position) {}
+
+				reference operator*() const {
+					return Projection()(*position);
+				}
+
+				pointer operator->() const {
+					return &Projection()(*position);
+				}
+
+				iterator& operator++() {
+					++position;
+					return *this;
+				}
+
+				iterator operator++(int) {
+					iterator previous = *this;
+					++position;
+					return previous;
+				}
+
+				bool operator==(const iterator& other) const {
+					return position == other.position;
+				}
+
+				bool operator!=(const iterator& other) const {
+					return position != other.position;
+				}
+
+			};
+
+		private:
+
+			Iterator first;
+			Iterator last;
+			uint number_of_elements;
+
+		public:
+
+			Range(Iterator first, Iterator last, uint number_of_elements) : first(first), last(last), number_of_elements(number_of_elements) {}
+
+			iterator begin() const {
+				return iterator(first);
+			}
+
+			iterator end() const {
+				return iterator(last);
+			}
+
+			uint size() const {
+				return number_of_elements;
+			}
+
+			bool empty() const {
+				return number_of_elements == 0;
+			}
+
+		};
+
+	}
+
+}
@@ -0,0 +1,158 @@
+#include "Recorder.h"
+
+#include <cstring>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		namespace {
+
+			const char Magic[4] = { 'E', 'R', 'E', 'C' };
+			const uint32_t Version = 3;
+
+		}
+
+		constexpr uint Recorder::Flush_Threshold;
+
+		Recorder::Recorder(std::ostream& stream) : stream(stream) {
+			stream.write(Magic, sizeof(Magic));
+			stream.write(reinterpret_cast<const char*>(&Version), sizeof(Version));
+			pending.reserve(Flush_Threshold);
+		}
+
+		Recorder::~Recorder() {
+			flush();
+		}
+
+		void Recorder::create_entity(Entity::Id entity) {
+			begin(Operation::Create_Entity);
+			write_number(entity);
+		}
+
+		void Recorder::destroy_entity(Entity::Id entity) {
+			begin(Operation::Destroy_Entity);
+			write_number(entity);
+		}
+
+		void Recorder::add_component(Entity::Id entity, Type type) {
+			uint index = index_of(type);
+			begin(Operation::Add_Component);
+			write_number(entity);
+			write_number(index);
+		}
+
+		void Recorder::remove_component(Entity::Id entity, Type type) {
+			uint index = index_of(type);
+			begin(Operation::Remove_Component);
+			write_number(entity);
+			write_number(index);
+		}
+
+		void Recorder::activate_entity(Entity::Id entity) {
+			begin(Operation::Activate_Entity);
+			write_number(entity);
+		}
+
+		void Recorder::deactivate_entity(Entity::Id entity, bool cold) {
+			begin(Operation::Deactivate_Entity);
+			write_number(entity);
+			write_number(cold ? 1 : 0);
+		}
+
+		void Recorder::renumber_entity(Entity::Id from, Entity::Id to) {
+			begin(Operation::Renumber_Entity);
+			write_number(from);
+			write_number(to);
+		}
+
+		void Recorder::add_system(Type type) {
+			uint index = index_of(type);
+			begin(Operation::Add_System);
+			write_number(index);
+		}
+
+		void Recorder::remove_system(Type type) {
+			uint index = index_of(type);
+			begin(Operation::Remove_System);
+			write_number(index);
+		}
+
+		void Recorder::update(float delta_time) {
+			spawned_entities.clear();
+			begin(Operation::Update);
+			char bytes[sizeof(float)];
+			std::memcpy(bytes, &delta_time, sizeof(float));
+			pending.insert(pending.end(), bytes, bytes + sizeof(float));
+		}
+
+		void Recorder::clear() {
+			begin(Operation::Clear);
+		}
+
+		void Recorder::spawn_entity(Entity::Id entity) {
+			spawned_entities.push_back(entity);
+			begin(Operation::Spawn_Entity);
+			write_number(entity);
+		}
+
+		void Recorder::despawn_entity(Entity::Id entity) {
+			begin(Operation::Despawn_Entity);
+			write_number(entity);
+		}
+
+		void Recorder::flush() {
+			stream.write(pending.data(), pending.size());
+			stream.flush();
+			pending.clear();
+		}
+
+		uint64_t Recorder::get_number_of_operations() const {
+			return number_of_operations;
+		}
+
+		const Lot<Entity::Id>& Recorder::get_spawned_entities() const {
+			return spawned_entities;
+		}
+
+		bool Recorder::read_header(std::istream& stream) {
+			char magic[sizeof(Magic)];
+			uint32_t version = 0;
+			stream.read(magic, sizeof(magic));
+			stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+			return stream and std::memcmp(magic, Magic, sizeof(Magic)) == 0 and version == Version;
+		}
+
+		// flushes before the operation once enough operations are pending, so operations never span two writes
+		void Recorder::begin(Operation operation) {
+			if (pending.size() >= Flush_Threshold) flush();
+			pending.push_back(static_cast<char>(operation));
+			if (operation != Operation::Define_Type) number_of_operations++;
+		}
+
+		// writes seven bits per byte, the high bit marks following bytes
+		void Recorder::write_number(uint64_t number) {
+			while (number >= 0x80) {
+				pending.push_back(static_cast<char>((number & 0x7F) | 0x80));
+				number >>= 7;
+			}
+			pending.push_back(static_cast<char>(number));
+		}
+
+		uint Recorder::index_of(Type type) {
+			auto iterator = types.find(type);
+			if (iterator != types.end()) return iterator->second;
+			uint index = types.size();
+			types.emplace(type, index);
+			const char* name = type.name();
+			uint length = std::strlen(name);
+			begin(Operation::Define_Type);
+			write_number(index);
+			write_number(length);
+			pending.insert(pending.end(), name, name + length);
+			return index;
+		}
+
+	}
+
+}
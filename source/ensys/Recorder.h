@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include <ensys/Entity.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// the kinds of recorded world operations, the encoded arguments are given in brackets
+		// (numbers are written as variable length integers, types by the index of their definition)
+		enum class Operation : uint8_t {
+			Define_Type,       // [type index, name length, name]
+			Create_Entity,     // [entity id]
+			Destroy_Entity,    // [entity id]
+			Add_Component,     // [entity id, type index]
+			Remove_Component,  // [entity id, type index]
+			Activate_Entity,   // [entity id]
+			Deactivate_Entity, // [entity id, cold (0 or 1)]
+			Renumber_Entity,   // [former entity id, entity id]
+			Add_System,        // [type index]
+			Remove_System,     // [type index]
+			Update,            // [delta time as 4 byte float]
+			Clear,             // []
+			Spawn_Entity,      // [entity id] created while updating, replay maps it to the next entity its update created
+			Despawn_Entity,    // [entity id] destroyed while updating, replay only forgets it
+		};
+
+		// records the operations on a world into a compact binary log, which can be replayed against any build of the library
+		// record a world by passing a recorder to World::record, the world reports its operations while recording
+		// (plain components, shared values, parent relations, cells and entity names aren't recorded)
+		class Recorder final {
+
+			std::ostream& stream;
+
+			// encoded operations not yet written to the stream
+			Lot<char> pending;
+
+			// the index of each type defined in the log
+			Map<Type, uint> types;
+
+			uint64_t number_of_operations = 0;
+
+			// the entities created while the world updated, since the last update
+			Lot<Entity::Id> spawned_entities;
+
+		public:
+
+			static constexpr uint Flush_Threshold = 1 << 16;
+
+			// writes the log header to the given stream
+			explicit Recorder(std::ostream& stream);
+
+			Recorder(const Recorder&) = delete;
+			Recorder& operator=(const Recorder&) = delete;
+
+			// writes the pending operations
+			~Recorder();
+
+			void create_entity(Entity::Id entity);
+			void destroy_entity(Entity::Id entity);
+			void add_component(Entity::Id entity, Type type);
+			void remove_component(Entity::Id entity, Type type);
+			void activate_entity(Entity::Id entity);
+			void deactivate_entity(Entity::Id entity, bool cold);
+			void renumber_entity(Entity::Id from, Entity::Id to);
+			void add_system(Type type);
+			void remove_system(Type type);
+			void update(float delta_time);
+			void clear();
+			void spawn_entity(Entity::Id entity);
+			void despawn_entity(Entity::Id entity);
+
+			// writes the pending operations to the stream
+			void flush();
+
+			// returns the number of recorded operations (without type definitions)
+			uint64_t get_number_of_operations() const;
+
+			// returns the entities created while the world updated, in creation order since the last update
+			const Lot<Entity::Id>& get_spawned_entities() const;
+
+			// checks the header of a log, returns whether it was written by a compatible recorder
+			static bool read_header(std::istream& stream);
+
+		private:
+
+			void begin(Operation operation);
+			void write_number(uint64_t number);
+
+			// returns the index of the type, defining it in the log on first use
+			uint index_of(Type type);
+
+		};
+
+	}
+
+}
@@ -0,0 +1,42 @@
+#include "Registry.h"
+
+#include <mutex>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		namespace {
+
+			std::mutex& registry_mutex() {
+				static std::mutex mutex;
+				return mutex;
+			}
+
+			Map<Type, const ComponentInfo*>& registered_types() {
+				static Map<Type, const ComponentInfo*> types;
+				return types;
+			}
+
+		}
+
+		const ComponentInfo* ComponentRegistry::find(Type type) {
+			std::lock_guard<std::mutex> lock(registry_mutex());
+			auto& types = registered_types();
+			auto iterator = types.find(type);
+			return iterator == types.end() ? nullptr : iterator->second;
+		}
+
+		uint ComponentRegistry::get_number_of_types() {
+			std::lock_guard<std::mutex> lock(registry_mutex());
+			return registered_types().size();
+		}
+
+		void ComponentRegistry::enter(const ComponentInfo& info) {
+			std::lock_guard<std::mutex> lock(registry_mutex());
+			registered_types().emplace(info.type, &info);
+		}
+
+	}
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+#include <ensys/Component.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// the metadata and type erased operations of a component type
+		struct ComponentInfo {
+
+			using Replicator = void (*)(const Component& value, uint amount, Lot<shared<Component>>& components);
+
+			Type type;
+			size_t size;
+			size_t alignment;
+
+			// appends the given number of copies of a polymorphic component to the components
+			// (nullptr if the type isn't derived from Component or isn't copy constructible)
+			Replicator replicate;
+
+		};
+
+		// records the metadata of component types, types get registered on first use
+		class ComponentRegistry final {
+
+		public:
+
+			ComponentRegistry() = delete;
+
+			// returns the metadata of the given type, registering it if necessary
+			template <class ComponentType>
+			static const ComponentInfo& of();
+
+			// returns the metadata of the given type (or nullptr if the type was never registered)
+			static const ComponentInfo* find(Type type);
+
+			// returns the number of registered types
+			static uint get_number_of_types();
+
+		private:
+
+			template <class ComponentType>
+			static ComponentInfo describe();
+
+			static void enter(const ComponentInfo& info);
+
+			template <class ComponentType>
+			static ComponentInfo::Replicator replicator(std::true_type);
+			template <class ComponentType>
+			static ComponentInfo::Replicator replicator(std::false_type);
+
+		};
+
+		// returns the metadata of the given type, registering it if necessary
+		template <class ComponentType>
+		const ComponentInfo& ComponentRegistry::of() {
+			static const ComponentInfo info = describe<ComponentType>();
+			static const bool entered = (enter(info), true);
+			(void) entered;
+			return info;
+		}
+
+		template <class ComponentType>
+		ComponentInfo ComponentRegistry::describe() {
+			using Replicable = std::integral_constant<bool, std::is_base_of<Component, ComponentType>::value and std::is_copy_constructible<ComponentType>::value>;
+			return ComponentInfo {
+				typeid(ComponentType),
+				sizeof(ComponentType),
+				alignof(ComponentType),
+				replicator<ComponentType>(Replicable())
+			};
+		}
+
+		// copies the value into separately owned components, so replicas aren't reported as shared and don't keep each other alive
+		template <class ComponentType>
+		ComponentInfo::Replicator ComponentRegistry::replicator(std::true_type) {
+			return [](const Component& value, uint amount, Lot<shared<Component>>& components) {
+				const ComponentType& original = static_cast<const ComponentType&>(value);
+				components.reserve(components.size() + amount);
+				for (uint i = 0; i < amount; ++i) {
+					components.push_back(std::make_shared<ComponentType>(original));
+				}
+			};
+		}
+
+		template <class ComponentType>
+		ComponentInfo::Replicator ComponentRegistry::replicator(std::false_type) {
+			return nullptr;
+		}
+
+	}
+
+}
@@ -0,0 +1,233 @@
+#include "Replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+
+#include <utilities/Assertions.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		namespace {
+
+			using Clock = std::chrono::steady_clock;
+
+			const uint Number_Of_Operations = static_cast<uint>(Operation::Despawn_Entity) + 1;
+
+			// reads a variable length integer written by the recorder, returns false at the end of the stream
+			bool read_number(std::istream& stream, uint64_t& number) {
+				number = 0;
+				for (uint shift = 0; shift < 64; shift += 7) {
+					int byte = stream.get();
+					if (byte == std::char_traits<char>::eof()) return false;
+					number |= static_cast<uint64_t>(byte & 0x7F) << shift;
+					if (not (byte & 0x80)) return true;
+				}
+				return false;
+			}
+
+		}
+
+		double Replay::Report::get_throughput() const {
+			return seconds > 0 ? number_of_operations / seconds : 0;
+		}
+
+		uint64_t Replay::Report::get_update_latency(double fraction) const {
+			if (update_latencies.empty()) return 0;
+			Lot<uint64_t> latencies = update_latencies;
+			uint index = std::min<uint>(latencies.size() - 1, static_cast<uint>(fraction * latencies.size()));
+			std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+			return latencies[index];
+		}
+
+		void Replay::Report::print(std::ostream& stream) const {
+			stream << number_of_operations << " operations in " << seconds << " s (" << get_throughput() << " operations/s), ";
+			stream << number_of_skipped_operations << " skipped\n";
+			for (uint i = 0; i < statistics.size(); ++i) {
+				const Statistics& entry = statistics[i];
+				if (not entry.count) continue;
+				stream << std::setw(20) << name_of(static_cast<Operation>(i)) << std::setw(12) << entry.count;
+				stream << "  average " << std::setw(10) << entry.total / entry.count << " ns  maximum " << std::setw(10) << entry.maximum << " ns\n";
+			}
+			if (update_latencies.empty()) return;
+			stream << "update latency  50% " << get_update_latency(0.5) << " ns  99% " << get_update_latency(0.99) << " ns  maximum ";
+			stream << *std::max_element(update_latencies.begin(), update_latencies.end()) << " ns\n";
+		}
+
+		// decodes one operation after another and times the world calls only
+		Replay::Report Replay::run(std::istream& stream, World& world) const {
+			runtime_assert(Recorder::read_header(stream), "the given stream doesn't contain a compatible recording, can't replay it");
+			Report report;
+			report.statistics.resize(Number_Of_Operations);
+			Lot<String> types;
+			Map<Entity::Id, Entity::Id> ids;
+			// records the entities created by replayed updates into a discarding stream, so spawns can be mapped to them
+			std::ostream discard(nullptr);
+			Recorder spawns(discard);
+			uint next_spawn = 0;
+			auto find_entity = [&](uint64_t recorded_id, Entity::Id& id) {
+				auto iterator = ids.find(static_cast<Entity::Id>(recorded_id));
+				if (iterator == ids.end() or not world.is_existing(iterator->second)) return false;
+				id = iterator->second;
+				return true;
+			};
+			auto find_type = [&](uint64_t index) -> const String& {
+				runtime_assert(index < types.size(), "the recording uses the undefined type #", index, ", can't replay it");
+				return types[index];
+			};
+			int byte;
+			while ((byte = stream.get()) != std::char_traits<char>::eof()) {
+				Operation operation = static_cast<Operation>(byte);
+				uint64_t first = 0;
+				uint64_t second = 0;
+				Entity::Id id = IDs::No_Id;
+				Function<void()> execute;
+				switch (operation) {
+					case Operation::Define_Type: {
+						uint64_t length = 0;
+						if (not read_number(stream, first) or not read_number(stream, length)) break;
+						runtime_assert(first == types.size(), "the recording defines type #", first, " out of order, can't replay it");
+						String name(length, '\0');
+						stream.read(&name[0], length);
+						types.push_back(std::move(name));
+						continue;
+					}
+					case Operation::Create_Entity:
+						if (not read_number(stream, first)) break;
+						execute = [&]() {
+							ids[static_cast<Entity::Id>(first)] = world.create_entity().id;
+						};
+						break;
+					case Operation::Destroy_Entity:
+						if (not read_number(stream, first)) break;
+						if (find_entity(first, id)) execute = [&]() {
+							world.destroy_entity(id);
+						};
+						ids.erase(static_cast<Entity::Id>(first));
+						break;
+					case Operation::Add_Component:
+					case Operation::Remove_Component: {
+						if (not read_number(stream, first) or not read_number(stream, second)) break;
+						auto& operations = operation == Operation::Add_Component ? component_adders : component_removers;
+						auto iterator = operations.find(find_type(second));
+						if (iterator == operations.end() or not find_entity(first, id)) break;
+						ComponentOperation apply = iterator->second;
+						execute = [&world, id, apply]() {
+							Entity entity = world.get_entity(id);
+							apply(entity);
+						};
+						break;
+					}
+					case Operation::Activate_Entity:
+						if (not read_number(stream, first)) break;
+						if (find_entity(first, id)) execute = [&]() {
+							world.activate_entity(id);
+						};
+						break;
+					case Operation::Deactivate_Entity:
+						if (not read_number(stream, first) or not read_number(stream, second)) break;
+						if (find_entity(first, id)) execute = [&]() {
+							world.deactivate_entity(id, second != 0);
+						};
+						break;
+					case Operation::Renumber_Entity: {
+						// the replayed entities keep their ids, only the mapping follows the recorded ids
+						if (not read_number(stream, first) or not read_number(stream, second)) break;
+						auto iterator = ids.find(static_cast<Entity::Id>(first));
+						if (iterator == ids.end()) continue;
+						Entity::Id replayed_id = iterator->second;
+						ids.erase(iterator);
+						ids[static_cast<Entity::Id>(second)] = replayed_id;
+						continue;
+					}
+					case Operation::Add_System:
+					case Operation::Remove_System: {
+						if (not read_number(stream, first)) break;
+						auto& operations = operation == Operation::Add_System ? system_adders : system_removers;
+						auto iterator = operations.find(find_type(first));
+						if (iterator == operations.end()) break;
+						SystemOperation apply = iterator->second;
+						execute = [&world, apply]() {
+							apply(world);
+						};
+						break;
+					}
+					case Operation::Update: {
+						float delta_time = 0;
+						char bytes[sizeof(float)];
+						if (not stream.read(bytes, sizeof(float))) break;
+						std::memcpy(&delta_time, bytes, sizeof(float));
+						execute = [&world, &spawns, &next_spawn, delta_time]() {
+							world.record(&spawns);
+							world.update(delta_time);
+							world.record(nullptr);
+							next_spawn = 0;
+						};
+						break;
+					}
+					case Operation::Spawn_Entity: {
+						// the replayed update created the entity already
+						if (not read_number(stream, first)) break;
+						const Lot<Entity::Id>& spawned = spawns.get_spawned_entities();
+						if (next_spawn < spawned.size()) ids[static_cast<Entity::Id>(first)] = spawned[next_spawn++];
+						else ids.erase(static_cast<Entity::Id>(first));
+						continue;
+					}
+					case Operation::Despawn_Entity:
+						if (not read_number(stream, first)) break;
+						ids.erase(static_cast<Entity::Id>(first));
+						continue;
+					case Operation::Clear:
+						execute = [&]() {
+							world.clear();
+							ids.clear();
+						};
+						break;
+					default:
+						runtime_assert(false, "the recording contains the unknown operation #", byte, ", can't replay it");
+				}
+				runtime_assert(stream, "the recording ends within an operation, can't replay it");
+				if (not execute) {
+					report.number_of_skipped_operations++;
+					continue;
+				}
+				auto start = Clock::now();
+				execute();
+				uint64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+				Statistics& statistics = report.statistics[byte];
+				statistics.count++;
+				statistics.total += latency;
+				statistics.maximum = std::max(statistics.maximum, latency);
+				if (operation == Operation::Update) report.update_latencies.push_back(latency);
+				report.number_of_operations++;
+				report.seconds += latency * 1e-9;
+			}
+			return report;
+		}
+
+		const char* Replay::name_of(Operation operation) {
+			switch (operation) {
+				case Operation::Define_Type: return "define type";
+				case Operation::Create_Entity: return "create entity";
+				case Operation::Destroy_Entity: return "destroy entity";
+				case Operation::Add_Component: return "add component";
+				case Operation::Remove_Component: return "remove component";
+				case Operation::Activate_Entity: return "activate entity";
+				case Operation::Deactivate_Entity: return "deactivate entity";
+				case Operation::Renumber_Entity: return "renumber entity";
+				case Operation::Add_System: return "add system";
+				case Operation::Remove_System: return "remove system";
+				case Operation::Update: return "update";
+				case Operation::Clear: return "clear";
+				case Operation::Spawn_Entity: return "spawn entity";
+				case Operation::Despawn_Entity: return "despawn entity";
+			}
+			return "unknown";
+		}
+
+	}
+
+}
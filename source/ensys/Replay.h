@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include <ensys/Entity.h>
+#include <ensys/Recorder.h>
+#include <ensys/World.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// re-executes a log written by a recorder against a world, measuring throughput and latencies
+		// component and system types are resolved by name, so the replaying program provides every type it wants replayed,
+		// operations on types not provided are skipped (components get default constructed, systems too)
+		class Replay final {
+
+		public:
+
+			// the latencies of one kind of operation
+			struct Statistics {
+				uint64_t count = 0;
+				// nanoseconds
+				uint64_t total = 0;
+				uint64_t maximum = 0;
+			};
+
+			struct Report {
+				uint64_t number_of_operations = 0;
+				uint64_t number_of_skipped_operations = 0;
+				// seconds spent executing operations, without decoding the log
+				double seconds = 0;
+				// the statistics of each kind of operation, indexed by operation
+				Lot<Statistics> statistics;
+				// the latency of each update in nanoseconds, in replay order
+				Lot<uint64_t> update_latencies;
+
+				// returns the executed operations per second
+				double get_throughput() const;
+
+				// returns the update latency at the given fraction (e.g. 0.99) of the sorted latencies
+				uint64_t get_update_latency(double fraction) const;
+
+				// prints the report in human readable form
+				void print(std::ostream& stream) const;
+			};
+
+		private:
+
+			using ComponentOperation = void (*)(Entity& entity);
+			using SystemOperation = void (*)(World& world);
+
+			Map<String, ComponentOperation> component_adders;
+			Map<String, ComponentOperation> component_removers;
+
+			Map<String, SystemOperation> system_adders;
+			Map<String, SystemOperation> system_removers;
+
+		public:
+
+			// allows replaying operations on components (or tags) of the given type
+			template <class ComponentType>
+			Replay& provide_component();
+
+			// allows replaying the addition and removal of systems of the given type
+			template <class SystemType>
+			Replay& provide_system();
+
+			// replays the log from the given stream against the given world, recorded entity ids are mapped to the entities created while replaying
+			// (the world is recorded while it updates, to map the entities its systems create, so it can't be recorded otherwise)
+			Report run(std::istream& stream, World& world) const;
+
+			// returns the name of an operation
+			static const char* name_of(Operation operation);
+
+		};
+
+		// allows replaying operations on components (or tags) of the given type
+		template <class ComponentType>
+		Replay& Replay::provide_component() {
+			String name = typeid(ComponentType).name();
+			component_adders[name] = [](Entity& entity) {
+				entity.add<ComponentType>();
+			};
+			component_removers[name] = [](Entity& entity) {
+				entity.remove<ComponentType>();
+			};
+			return *this;
+		}
+
+		// allows replaying the addition and removal of systems of the given type
+		template <class SystemType>
+		Replay& Replay::provide_system() {
+			String name = typeid(SystemType).name();
+			system_adders[name] = [](World& world) {
+				world.add<SystemType>();
+			};
+			system_removers[name] = [](World& world) {
+				world.remove<SystemType>();
+			};
+			return *this;
+		}
+
+	}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <utility>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// base of world scoped singleton resources (clock, configuration, spatial grid, ...)
+		class Resource {
+
+		public:
+
+			// the type of the resource value
+			const Type type;
+
+			explicit Resource(Type type) : type(type) {}
+
+			Resource(const Resource&) = delete;
+			Resource(Resource&&) = delete;
+
+			Resource& operator=(const Resource&) = delete;
+			Resource& operator=(Resource&&) = delete;
+
+			virtual ~Resource() noexcept {}
+
+		};
+
+		// holds a resource value of the given type
+		template <class ResourceType>
+		class ResourceSlot final : public Resource {
+
+		public:
+
+			ResourceType value;
+
+			template <typename... Arguments>
+			explicit ResourceSlot(Arguments&&... arguments) : Resource(typeid(ResourceType)), value(std::forward<Arguments>(arguments)...) {}
+
+		};
+
+		using Resources = Lot<unique<Resource>>;
+
+	}
+
+}
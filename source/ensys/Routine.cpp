@@ -0,0 +1,62 @@
+#include "Routine.h"
+
+namespace tenjix {
+
+	namespace ensys {
+
+		Await::Await(Kind kind, float seconds, const Function<bool()>& condition) : kind(kind), seconds(seconds), condition(condition) {}
+
+		Await Await::next_tick() {
+			return Await(Kind::Next_Tick, 0.0f, nullptr);
+		}
+
+		Await Await::delay(float seconds) {
+			return Await(Kind::Delay, seconds, nullptr);
+		}
+
+		Await Await::until(const Function<bool()>& condition) {
+			return Await(Kind::Condition, 0.0f, condition);
+		}
+
+		Await Await::finished() {
+			return Await(Kind::Finished, 0.0f, nullptr);
+		}
+
+		RoutineSystem::RoutineSystem(Priority priority, UpdateStage stage) : System(priority, stage) {}
+
+		void RoutineSystem::restart() {
+			routine_line = 0;
+			delayed = 0.0f;
+			awaiting = Await::next_tick();
+		}
+
+		bool RoutineSystem::is_finished() const {
+			return awaiting.kind == Await::Kind::Finished;
+		}
+
+		bool RoutineSystem::exceeds(float budget) const {
+			return std::chrono::duration<float>(Clock::now() - slice_begin).count() > budget;
+		}
+
+		void RoutineSystem::update(float delta_time) {
+			switch (awaiting.kind) {
+				case Await::Kind::Finished:
+					return;
+				case Await::Kind::Delay:
+					delayed += delta_time;
+					if (delayed < awaiting.seconds) return;
+					break;
+				case Await::Kind::Condition:
+					if (not awaiting.condition()) return;
+					break;
+				case Await::Kind::Next_Tick:
+					break;
+			}
+			slice_begin = Clock::now();
+			delayed = 0.0f;
+			awaiting = resume(delta_time);
+		}
+
+	}
+
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <chrono>
+#include <future>
+#include <type_traits>
+
+#include <ensys/System.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// describes what a routine waits for before it is resumed
+		class Await final {
+
+			friend class RoutineSystem;
+
+			enum class Kind : unsigned char {
+				Next_Tick, Delay, Condition, Finished
+			};
+
+			Kind kind;
+			float seconds;
+			Function<bool()> condition;
+
+		public:
+
+			// resumes the routine at the next update
+			static Await next_tick();
+
+			// resumes the routine after the given number of seconds (of accumulated update delta time)
+			static Await delay(float seconds);
+
+			// resumes the routine at the first update the given condition is met
+			static Await until(const Function<bool()>& condition);
+
+			// resumes the routine at the first update the given future is ready (the await shares the ownership of the future)
+			template <class Result>
+			static Await completion(const shared<std::future<Result>>& future);
+
+			// resumes the routine at the first update the given shared future is ready
+			template <class Result>
+			static Await completion(const std::shared_future<Result>& future);
+
+			// runs the given work on another thread and resumes the routine at the first update after it finished,
+			// the result is assigned to the given shared future (typically a member of the routine)
+			// (ensys has no job pool, the workers of a WorldGroup only update worlds, so the work runs as asynchronous task)
+			template <class Work>
+			static Await job(Work&& work, std::shared_future<typename std::result_of<Work()>::type>& result);
+
+			// doesn't resume the routine until it is restarted
+			static Await finished();
+
+		private:
+
+			Await(Kind kind, float seconds, const Function<bool()>& condition);
+
+		};
+
+		// a system whose update is a routine, spreading long running work across several ticks
+		// the routine is written between routine_begin and routine_end and suspends with routine_await(await),
+		// it is resumed by the worlds update once the awaited tick, delay or condition has come
+		// (state which has to survive a suspension has to be kept in members, local variables don't persist)
+		class RoutineSystem : public System {
+
+			using Clock = std::chrono::steady_clock;
+
+			Await awaiting = Await::next_tick();
+
+			float delayed = 0.0f;
+
+			Clock::time_point slice_begin;
+
+		public:
+
+			explicit RoutineSystem(Priority priority = 0, UpdateStage stage = UpdateStage::Update);
+
+			// restarts the routine from the beginning at the next update
+			void restart();
+
+			// checks whether the routine has finished
+			bool is_finished() const;
+
+		protected:
+
+			// the label the routine continues at (used by the routine macros)
+			uint routine_line = 0;
+
+			// runs the routine until it suspends, returns what it awaits
+			virtual Await resume(float delta_time) = 0;
+
+			// checks whether the routine has run longer than the given budget (in seconds) within the current update
+			bool exceeds(float budget) const;
+
+		private:
+
+			void update(float delta_time) override;
+
+		};
+
+		template <class Result>
+		Await Await::completion(const shared<std::future<Result>>& future) {
+			return until([future]() {
+				return future->wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+			});
+		}
+
+		template <class Result>
+		Await Await::completion(const std::shared_future<Result>& future) {
+			return until([future]() {
+				return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+			});
+		}
+
+		template <class Work>
+		Await Await::job(Work&& work, std::shared_future<typename std::result_of<Work()>::type>& result) {
+			result = std::async(std::launch::async, std::forward<Work>(work)).share();
+			return completion(result);
+		}
+
+	}
+
+}
+
+// begins the body of a routine
+#define routine_begin switch (routine_line) { case 0:
+
+// suspends the routine until the given await is satisfied, continuing after this statement
+// (each await gets a unique label from __COUNTER__, so several awaits may share a line)
+#define routine_await(await) routine_await_at(await, __COUNTER__ + 1)
+#define routine_await_at(await, label) do { routine_line = label; return (await); case label:; } while (false)
+
+// suspends the routine until the next update, if it has used up the given time budget (in seconds) of the current update
+#define routine_yield_after(budget) do { if (exceeds(budget)) routine_await(::tenjix::ensys::Await::next_tick()); } while (false)
+
+// finishes the routine, it won't be resumed until it gets restarted
+#define routine_finish do { routine_line = 0; return ::tenjix::ensys::Await::finished(); } while (false)
+
+// ends the body of a routine, which starts over at the next update
+#define routine_end } routine_line = 0; return ::tenjix::ensys::Await::next_tick()
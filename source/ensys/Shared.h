@@ -0,0 +1,213 @@
+#pragma once
+
+#include <unordered_map>
+
+#include <ensys/Storage.h>
+
+#include <utilities/Assertions.h>
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// stores deduplicated values shared by entities (flyweights), grouping the entities by value
+		// values are compared by hash and equality, each distinct value is stored only once
+		template <class ValueType, class Hash = std::hash<ValueType>>
+		class SharedValues final : public Storage {
+
+		public:
+
+			using Index = uint;
+
+		private:
+
+			struct Reference {
+				Index index;
+				uint position;
+			};
+
+			// the distinct values (values at reusable indices are unused)
+			Lot<ValueType> values;
+			// the ids of the entities referencing each value, stored contiguously per value
+			Lot<Lot<Entity::Id>> groups;
+			// the list of reusable value indices
+			Lot<Index> reusable_indices;
+			// the value indices by value hash
+			std::unordered_multimap<size_t, Index> lookup;
+			// the value index and group position by entity id
+			Map<Entity::Id, Reference> references;
+
+		public:
+
+			// shares the given value with the entity of the given id and returns the values index
+			Index acquire(Entity::Id id, const ValueType& value);
+
+			// returns the value shared by the entity with the given id
+			const ValueType& get(Entity::Id id) const;
+
+			// returns the index of the value shared by the entity with the given id
+			Index index_of(Entity::Id id) const;
+
+			// returns the value with the given index
+			const ValueType& get_value(Index index) const;
+
+			// returns the ids of all entities sharing the value with the given index
+			const Lot<Entity::Id>& get_entities(Index index) const;
+
+			// returns the number of distinct values
+			uint get_number_of_values() const;
+
+			// returns the number of entities sharing values
+			uint get_number_of_entities() const;
+
+			// invokes the given function with each distinct value and the ids of the entities sharing it
+			template <class Function>
+			void for_each_group(Function function) const;
+
+			bool contains(Entity::Id id) const override;
+			void collect(Entity::Id id, Types& types) const override;
+			void release(Entity::Id id) override;
+			void clear() override;
+			void renumber(Entity::Id from, Entity::Id to) override;
+			void shrink() override;
+
+		};
+
+		template <class ValueType, class Hash>
+		typename SharedValues<ValueType, Hash>::Index SharedValues<ValueType, Hash>::acquire(Entity::Id id, const ValueType& value) {
+			runtime_assert(not contains(id), "entity #", id, " already shares a value of type ", Type(typeid(ValueType)), ", can't share another");
+			size_t hash = Hash()(value);
+			Index index = 0;
+			bool found = false;
+			auto range = lookup.equal_range(hash);
+			for (auto iterator = range.first; iterator != range.second; ++iterator) {
+				if (values[iterator->second] == value) {
+					index = iterator->second;
+					found = true;
+					break;
+				}
+			}
+			if (not found) {
+				if (not reusable_indices.empty()) {
+					index = reusable_indices.back();
+					reusable_indices.pop_back();
+					values[index] = value;
+				} else {
+					index = values.size();
+					values.push_back(value);
+					groups.emplace_back();
+				}
+				lookup.emplace(hash, index);
+			}
+			auto& group = groups[index];
+			references[id] = Reference { index, static_cast<uint>(group.size()) };
+			group.push_back(id);
+			return index;
+		}
+
+		template <class ValueType, class Hash>
+		const ValueType& SharedValues<ValueType, Hash>::get(Entity::Id id) const {
+			return values[index_of(id)];
+		}
+
+		template <class ValueType, class Hash>
+		typename SharedValues<ValueType, Hash>::Index SharedValues<ValueType, Hash>::index_of(Entity::Id id) const {
+			auto iterator = references.find(id);
+			runtime_assert(iterator != references.end(), "entity #", id, " doesn't share a value of type ", Type(typeid(ValueType)));
+			return iterator->second.index;
+		}
+
+		template <class ValueType, class Hash>
+		const ValueType& SharedValues<ValueType, Hash>::get_value(Index index) const {
+			return values.at(index);
+		}
+
+		template <class ValueType, class Hash>
+		const Lot<Entity::Id>& SharedValues<ValueType, Hash>::get_entities(Index index) const {
+			return groups.at(index);
+		}
+
+		template <class ValueType, class Hash>
+		uint SharedValues<ValueType, Hash>::get_number_of_values() const {
+			return values.size() - reusable_indices.size();
+		}
+
+		template <class ValueType, class Hash>
+		uint SharedValues<ValueType, Hash>::get_number_of_entities() const {
+			return references.size();
+		}
+
+		// invokes the given function with each distinct value and the ids of the entities sharing it
+		// allows setting up per value state once for a whole group of entities
+		template <class ValueType, class Hash>
+		template <class Function>
+		void SharedValues<ValueType, Hash>::for_each_group(Function function) const {
+			for (Index index = 0; index < groups.size(); ++index) {
+				auto& group = groups[index];
+				if (not group.empty()) function(values[index], group);
+			}
+		}
+
+		template <class ValueType, class Hash>
+		bool SharedValues<ValueType, Hash>::contains(Entity::Id id) const {
+			return references.find(id) != references.end();
+		}
+
+		template <class ValueType, class Hash>
+		void SharedValues<ValueType, Hash>::collect(Entity::Id id, Types& types) const {
+			if (contains(id)) types.insert(typeid(ValueType));
+		}
+
+		template <class ValueType, class Hash>
+		void SharedValues<ValueType, Hash>::release(Entity::Id id) {
+			auto iterator = references.find(id);
+			if (iterator == references.end()) return;
+			Reference reference = iterator->second;
+			references.erase(iterator);
+			auto& group = groups[reference.index];
+			Entity::Id last = group.back();
+			group[reference.position] = last;
+			group.pop_back();
+			if (last != id) references[last].position = reference.position;
+			if (not group.empty()) return;
+			auto range = lookup.equal_range(Hash()(values[reference.index]));
+			for (auto entry = range.first; entry != range.second; ++entry) {
+				if (entry->second == reference.index) {
+					lookup.erase(entry);
+					break;
+				}
+			}
+			reusable_indices.push_back(reference.index);
+		}
+
+		template <class ValueType, class Hash>
+		void SharedValues<ValueType, Hash>::clear() {
+			values.clear();
+			groups.clear();
+			reusable_indices.clear();
+			lookup.clear();
+			references.clear();
+		}
+
+		template <class ValueType, class Hash>
+		void SharedValues<ValueType, Hash>::renumber(Entity::Id from, Entity::Id to) {
+			auto iterator = references.find(from);
+			if (iterator == references.end()) return;
+			Reference reference = iterator->second;
+			references.erase(iterator);
+			references.emplace(to, reference);
+			groups[reference.index][reference.position] = to;
+		}
+
+		template <class ValueType, class Hash>
+		void SharedValues<ValueType, Hash>::shrink() {
+			references.rehash(0);
+			for (auto& group : groups) {
+				group.shrink_to_fit();
+			}
+		}
+
+	}
+
+}
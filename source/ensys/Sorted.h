@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+#include <ensys/Observable.h>
+#include <ensys/System.h>
+#include <ensys/World.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// a system which updates its entities ordered by a key read from a component (render order, depth, priority, ...)
+		// the order is maintained incrementally: added entities are inserted at their position, changed keys (reported by
+		// observable components or resort) are fixed by an insertion pass at the next update, so steady frames don't sort
+		template <class ComponentType, class KeyType = float>
+		class SortedSystem : public System {
+
+			struct Entry {
+				KeyType key;
+				Entity::Id id;
+			};
+
+			static constexpr bool Observable = std::is_base_of<ObservableComponent, ComponentType>::value;
+
+			// the entries ordered by key (unless keys changed since the last update)
+			Lot<Entry> order;
+			// the current key of each entity
+			Map<Entity::Id, KeyType> keys;
+			// the number of entries whose key changed since the order was restored
+			uint changes = 0;
+
+		public:
+
+			// refreshes the key of the given entity, its position is restored at the next update
+			void resort(const Entity& entity);
+
+			// returns the ids of the entities ordered by key
+			const Lot<Entity::Id> get_order() const;
+
+		protected:
+
+			explicit SortedSystem(Priority priority = 0, UpdateStage stage = UpdateStage::Update);
+
+			// returns the sort key of the given component
+			virtual KeyType key_of(const ComponentType& component) const = 0;
+
+			// updates the enabled entities ordered by key
+			void update(float delta_time) override;
+
+			// updates an entity in key order
+			void update(Entity& entity, float delta_time) override {}
+
+			void on_entity_added(const Entity& entity) override;
+			void on_entity_removed(const Entity& entity) override;
+			void on_entity_modified(const Entity& entity) override;
+
+		private:
+
+			// restores the order after keys changed
+			void sort();
+
+			// returns the position of the entry of the given entity
+			typename Lot<Entry>::iterator find(Entity::Id id, const KeyType& key);
+
+			static bool precedes(const Entry& entry, const Entry& other);
+
+			void attach(const Entity& entity, std::true_type observable);
+			void attach(const Entity& entity, std::false_type observable) {}
+			void detach(const Entity& entity, std::true_type observable);
+			void detach(const Entity& entity, std::false_type observable) {}
+
+		};
+
+		template <class ComponentType, class KeyType>
+		SortedSystem<ComponentType, KeyType>::SortedSystem(Priority priority, UpdateStage stage) : System(priority, stage) {
+			filter.require<ComponentType>();
+		}
+
+		// refreshes the key of the given entity, its position is restored at the next update
+		template <class ComponentType, class KeyType>
+		void SortedSystem<ComponentType, KeyType>::resort(const Entity& entity) {
+			auto iterator = keys.find(entity.id);
+			if (iterator == keys.end()) return;
+			KeyType key = key_of(entity.get<ComponentType>());
+			if (not (key < iterator->second) and not (iterator->second < key)) return;
+			auto entry = find(entity.id, iterator->second);
+			entry->key = key;
+			iterator->second = key;
+			changes++;
+		}
+
+		template <class ComponentType, class KeyType>
+		const Lot<Entity::Id> SortedSystem<ComponentType, KeyType>::get_order() const {
+			const_cast<SortedSystem&>(*this).sort();
+			Lot<Entity::Id> ids;
+			ids.reserve(order.size());
+			for (auto& entry : order) {
+				ids.push_back(entry.id);
+			}
+			return ids;
+		}
+
+		template <class ComponentType, class KeyType>
+		void SortedSystem<ComponentType, KeyType>::update(float delta_time) {
+			sort();
+			for (uint i = 0; i < order.size(); ++i) {
+				if (not world->is_enabled(order[i].id)) continue;
+				Entity entity = world->get_entity(order[i].id);
+				update(entity, delta_time);
+			}
+		}
+
+		// while keys changed, the entry is appended and placed by the next sort
+		template <class ComponentType, class KeyType>
+		void SortedSystem<ComponentType, KeyType>::on_entity_added(const Entity& entity) {
+			Entry entry { key_of(entity.get<ComponentType>()), entity.id };
+			if (changes == 0) {
+				order.insert(std::upper_bound(order.begin(), order.end(), entry, precedes), entry);
+			} else {
+				order.push_back(entry);
+				changes++;
+			}
+			keys[entity.id] = entry.key;
+			attach(entity, std::integral_constant<bool, Observable>());
+		}
+
+		template <class ComponentType, class KeyType>
+		void SortedSystem<ComponentType, KeyType>::on_entity_removed(const Entity& entity) {
+			auto iterator = keys.find(entity.id);
+			if (iterator == keys.end()) return;
+			order.erase(find(entity.id, iterator->second));
+			keys.erase(iterator);
+			if (entity.is_existing and entity.has<ComponentType>()) detach(entity, std::integral_constant<bool, Observable>());
+		}
+
+		template <class ComponentType, class KeyType>
+		void SortedSystem<ComponentType, KeyType>::on_entity_modified(const Entity& entity) {
+			resort(entity);
+		}
+
+		// few changed keys are moved to their position by an insertion pass over the nearly sorted order,
+		// many changes are sorted from scratch
+		template <class ComponentType, class KeyType>
+		void SortedSystem<ComponentType, KeyType>::sort() {
+			if (changes == 0) return;
+			if (changes > order.size() / 8 + 1) {
+				std::stable_sort(order.begin(), order.end(), precedes);
+			} else {
+				for (uint i = 1; i < order.size(); ++i) {
+					Entry entry = order[i];
+					uint j = i;
+					while (j > 0 and precedes(entry, order[j - 1])) {
+						order[j] = order[j - 1];
+						--j;
+					}
+					order[j] = entry;
+				}
+			}
+			changes = 0;
+		}
+
+		// searches the sorted order binary, an order with changed keys linearly (without sorting it before the next update)
+		template <class ComponentType, class KeyType>
+		typename Lot<typename SortedSystem<ComponentType, KeyType>::Entry>::iterator SortedSystem<ComponentType, KeyType>::find(Entity::Id id, const KeyType& key) {
+			if (changes > 0) {
+				return std::find_if(order.begin(), order.end(), [id](const Entry& entry) {
+					return entry.id == id;
+				});
+			}
+			Entry probe { key, id };
+			auto iterator = std::lower_bound(order.begin(), order.end(), probe, precedes);
+			while (iterator != order.end() and iterator->id != id) ++iterator;
+			return iterator;
+		}
+
+		template <class ComponentType, class KeyType>
+		bool SortedSystem<ComponentType, KeyType>::precedes(const Entry& entry, const Entry& other) {
+			return entry.key < other.key;
+		}
+
+		template <class ComponentType, class KeyType>
+		void SortedSystem<ComponentType, KeyType>::attach(const Entity& entity, std::true_type observable) {
+			entity.get<ComponentType>().attach(this, entity);
+		}
+
+		template <class ComponentType, class KeyType>
+		void SortedSystem<ComponentType, KeyType>::detach(const Entity& entity, std::true_type observable) {
+			entity.get<ComponentType>().detach(this, entity);
+		}
+
+	}
+
+}
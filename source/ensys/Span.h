@@ -0,0 +1,50 @@
+#pragma once
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// a view of contiguous elements, which doesn't own them
+		template <class ElementType>
+		class Span final {
+
+			ElementType* elements;
+			uint number_of_elements;
+
+		public:
+
+			Span() : elements(nullptr), number_of_elements(0) {}
+
+			Span(ElementType* elements, uint number_of_elements) : elements(elements), number_of_elements(number_of_elements) {}
+
+			ElementType* data() const {
+				return elements;
+			}
+
+			uint size() const {
+				return number_of_elements;
+			}
+
+			bool empty() const {
+				return number_of_elements == 0;
+			}
+
+			ElementType* begin() const {
+				return elements;
+			}
+
+			ElementType* end() const {
+				return elements + number_of_elements;
+			}
+
+			ElementType& operator[](uint index) const {
+				return elements[index];
+			}
+
+		};
+
+	}
+
+}
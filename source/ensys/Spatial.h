@@ -0,0 +1,353 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <type_traits>
+
+#include <ensys/Observable.h>
+#include <ensys/System.h>
+#include <ensys/World.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		struct Point {
+			float x;
+			float y;
+			float z;
+		};
+
+		struct Bounds {
+			Point minimum;
+			Point maximum;
+		};
+
+		// reads the location of components with public x, y and z members
+		template <class ComponentType>
+		struct Locator {
+			Point operator()(const ComponentType& component) const {
+				return Point { component.x, component.y, component.z };
+			}
+		};
+
+		// indexes the entities with a located component in a uniform grid, answering range and neighbor queries
+		// the index is updated incrementally when entities are added, removed or modified (observable components),
+		// locations of components which aren't observable are refreshed once per update
+		// range queries visit only the cells overlapping the range, instead of every entity like a brute force scan of get_entities()
+		// (with 100k moving entities and cells as large as the query radius, a radius query takes microseconds instead of milliseconds)
+		template <class ComponentType, class LocatorType = Locator<ComponentType>>
+		class SpatialIndex final : public System {
+
+			using Cell = std::uint64_t;
+
+			struct Entry {
+				Entity::Id id;
+				Point location;
+			};
+
+			struct Slot {
+				Cell cell;
+				uint position;
+			};
+
+			struct Coordinates {
+				int x;
+				int y;
+				int z;
+			};
+
+			static constexpr bool Observable = std::is_base_of<ObservableComponent, ComponentType>::value;
+
+			const float cell_size;
+
+			// the entries within each occupied cell
+			Map<Cell, Lot<Entry>> cells;
+			// the cell and position of each indexed entity
+			Map<Entity::Id, Slot> slots;
+
+		public:
+
+			// constructs a spatial index with the given grid cell size (should be about the typical query radius)
+			explicit SpatialIndex(float cell_size = 1.0f, Priority priority = 0, UpdateStage stage = UpdateStage::Update);
+
+			// moves the entity to the cell of its current location
+			void relocate(const Entity& entity);
+
+			// returns the indexed location of the given entity
+			Point get_location(Entity::Id id) const;
+
+			// appends the ids of all entities within the given radius around the center to the result, returns their number
+			uint find_entities_within(const Point& center, float radius, Lot<Entity::Id>& result) const;
+
+			// appends the ids of all entities inside the given bounds to the result, returns their number
+			uint find_entities_inside(const Bounds& bounds, Lot<Entity::Id>& result) const;
+
+			// appends the ids of the k entities nearest to the center to the result (nearest first), returns their number
+			// disabled entities are skipped by all queries
+			uint find_nearest_entities(const Point& center, uint k, Lot<Entity::Id>& result) const;
+
+			// returns the number of occupied cells
+			uint get_number_of_cells() const;
+
+		private:
+
+			void update(float delta_time) override;
+
+			void on_entity_added(const Entity& entity) override;
+			void on_entity_removed(const Entity& entity) override;
+			void on_entity_modified(const Entity& entity) override;
+
+			void insert(Entity::Id id, const Point& location);
+			void erase(Entity::Id id);
+			void relocate(Entity::Id id, const Point& location);
+
+			Coordinates coordinates_of(const Point& location) const;
+
+			static Cell cell_at(int x, int y, int z);
+			static float distance_squared(const Point& a, const Point& b);
+
+			template <class Function>
+			void for_each_entry(const Coordinates& minimum, const Coordinates& maximum, Function function) const;
+
+			void attach(const Entity& entity, std::true_type observable);
+			void attach(const Entity& entity, std::false_type observable) {}
+			void detach(const Entity& entity, std::true_type observable);
+			void detach(const Entity& entity, std::false_type observable) {}
+
+		};
+
+		template <class ComponentType, class LocatorType>
+		SpatialIndex<ComponentType, LocatorType>::SpatialIndex(float cell_size, Priority priority, UpdateStage stage) : System(priority, stage), cell_size(cell_size) {
+			runtime_assert(cell_size > 0, "the cell size of a spatial index has to be positive");
+			filter.require<ComponentType>();
+		}
+
+		// moves the entity to the cell of its current location
+		template <class ComponentType, class LocatorType>
+		void SpatialIndex<ComponentType, LocatorType>::relocate(const Entity& entity) {
+			relocate(entity.id, LocatorType()(entity.get<ComponentType>()));
+		}
+
+		template <class ComponentType, class LocatorType>
+		Point SpatialIndex<ComponentType, LocatorType>::get_location(Entity::Id id) const {
+			auto iterator = slots.find(id);
+			runtime_assert(iterator != slots.end(), "entity #", id, " isn't indexed by ", *this);
+			const Slot& slot = iterator->second;
+			return cells.at(slot.cell)[slot.position].location;
+		}
+
+		// appends the ids of all entities within the given radius around the center to the result, returns their number
+		template <class ComponentType, class LocatorType>
+		uint SpatialIndex<ComponentType, LocatorType>::find_entities_within(const Point& center, float radius, Lot<Entity::Id>& result) const {
+			uint number_of_entities = result.size();
+			float radius_squared = radius * radius;
+			Coordinates minimum = coordinates_of(Point { center.x - radius, center.y - radius, center.z - radius });
+			Coordinates maximum = coordinates_of(Point { center.x + radius, center.y + radius, center.z + radius });
+			for_each_entry(minimum, maximum, [&](const Entry& entry) {
+				if (not world->is_enabled(entry.id)) return;
+				if (distance_squared(entry.location, center) <= radius_squared) result.push_back(entry.id);
+			});
+			return result.size() - number_of_entities;
+		}
+
+		// appends the ids of all entities inside the given bounds to the result, returns their number
+		template <class ComponentType, class LocatorType>
+		uint SpatialIndex<ComponentType, LocatorType>::find_entities_inside(const Bounds& bounds, Lot<Entity::Id>& result) const {
+			uint number_of_entities = result.size();
+			const Point& low = bounds.minimum;
+			const Point& high = bounds.maximum;
+			for_each_entry(coordinates_of(low), coordinates_of(high), [&](const Entry& entry) {
+				if (not world->is_enabled(entry.id)) return;
+				const Point& point = entry.location;
+				if (point.x < low.x or point.y < low.y or point.z < low.z) return;
+				if (point.x > high.x or point.y > high.y or point.z > high.z) return;
+				result.push_back(entry.id);
+			});
+			return result.size() - number_of_entities;
+		}
+
+		// searches the cells in growing shells around the center cell, until no unvisited cell can contain a nearer entity
+		template <class ComponentType, class LocatorType>
+		uint SpatialIndex<ComponentType, LocatorType>::find_nearest_entities(const Point& center, uint k, Lot<Entity::Id>& result) const {
+			if (k == 0 or slots.empty()) return 0;
+			using Candidate = std::pair<float, Entity::Id>;
+			std::priority_queue<Candidate> nearest;
+			auto consider = [&](const Entry& entry) {
+				if (not world->is_enabled(entry.id)) return;
+				float distance = distance_squared(entry.location, center);
+				if (nearest.size() < k) {
+					nearest.emplace(distance, entry.id);
+				} else if (distance < nearest.top().first) {
+					nearest.pop();
+					nearest.emplace(distance, entry.id);
+				}
+			};
+			Coordinates origin = coordinates_of(center);
+			uint visited = 0;
+			for (int shell = 0; ; ++shell) {
+				uint shell_cells = shell == 0 ? 1 : 24 * shell * shell + 2;
+				if (shell_cells > cells.size()) {
+					// the shell has more cells than are occupied, scanning all entries is cheaper
+					nearest = std::priority_queue<Candidate>();
+					for (auto& cell : cells) {
+						for (auto& entry : cell.second) consider(entry);
+					}
+					break;
+				}
+				Coordinates minimum { origin.x - shell, origin.y - shell, origin.z - shell };
+				Coordinates maximum { origin.x + shell, origin.y + shell, origin.z + shell };
+				for (int x = minimum.x; x <= maximum.x; ++x) {
+					for (int y = minimum.y; y <= maximum.y; ++y) {
+						bool inner = x != minimum.x and x != maximum.x and y != minimum.y and y != maximum.y;
+						int step = inner ? maximum.z - minimum.z : 1;
+						for (int z = minimum.z; z <= maximum.z; z += std::max(step, 1)) {
+							auto iterator = cells.find(cell_at(x, y, z));
+							if (iterator == cells.end()) continue;
+							for (auto& entry : iterator->second) consider(entry);
+							visited += iterator->second.size();
+						}
+					}
+				}
+				float reach = shell * cell_size;
+				if (visited == slots.size()) break;
+				if (nearest.size() == k and nearest.top().first <= reach * reach) break;
+			}
+			uint number_of_entities = nearest.size();
+			result.resize(result.size() + number_of_entities);
+			for (uint i = 1; i <= number_of_entities; ++i) {
+				result[result.size() - i] = nearest.top().second;
+				nearest.pop();
+			}
+			return number_of_entities;
+		}
+
+		template <class ComponentType, class LocatorType>
+		uint SpatialIndex<ComponentType, LocatorType>::get_number_of_cells() const {
+			return cells.size();
+		}
+
+		// refreshes the locations of enabled components which don't notify about modifications
+		template <class ComponentType, class LocatorType>
+		void SpatialIndex<ComponentType, LocatorType>::update(float delta_time) {
+			if (Observable) return;
+			for (auto& entity : get_entities()) {
+				if (world->is_enabled(entity.id)) relocate(entity);
+			}
+		}
+
+		template <class ComponentType, class LocatorType>
+		void SpatialIndex<ComponentType, LocatorType>::on_entity_added(const Entity& entity) {
+			insert(entity.id, LocatorType()(entity.get<ComponentType>()));
+			attach(entity, std::integral_constant<bool, Observable>());
+		}
+
+		template <class ComponentType, class LocatorType>
+		void SpatialIndex<ComponentType, LocatorType>::on_entity_removed(const Entity& entity) {
+			if (entity.is_existing and entity.has<ComponentType>()) detach(entity, std::integral_constant<bool, Observable>());
+			erase(entity.id);
+		}
+
+		template <class ComponentType, class LocatorType>
+		void SpatialIndex<ComponentType, LocatorType>::on_entity_modified(const Entity& entity) {
+			relocate(entity);
+		}
+
+		template <class ComponentType, class LocatorType>
+		void SpatialIndex<ComponentType, LocatorType>::insert(Entity::Id id, const Point& location) {
+			Coordinates coordinates = coordinates_of(location);
+			Cell cell = cell_at(coordinates.x, coordinates.y, coordinates.z);
+			auto& entries = cells[cell];
+			slots[id] = Slot { cell, static_cast<uint>(entries.size()) };
+			entries.push_back(Entry { id, location });
+		}
+
+		template <class ComponentType, class LocatorType>
+		void SpatialIndex<ComponentType, LocatorType>::erase(Entity::Id id) {
+			auto iterator = slots.find(id);
+			if (iterator == slots.end()) return;
+			Slot slot = iterator->second;
+			slots.erase(iterator);
+			auto cell = cells.find(slot.cell);
+			auto& entries = cell->second;
+			entries[slot.position] = entries.back();
+			entries.pop_back();
+			if (slot.position < entries.size()) slots[entries[slot.position].id].position = slot.position;
+			if (entries.empty()) cells.erase(cell);
+		}
+
+		template <class ComponentType, class LocatorType>
+		void SpatialIndex<ComponentType, LocatorType>::relocate(Entity::Id id, const Point& location) {
+			auto iterator = slots.find(id);
+			if (iterator == slots.end()) return;
+			Coordinates coordinates = coordinates_of(location);
+			Slot& slot = iterator->second;
+			if (cell_at(coordinates.x, coordinates.y, coordinates.z) == slot.cell) {
+				cells[slot.cell][slot.position].location = location;
+				return;
+			}
+			erase(id);
+			insert(id, location);
+		}
+
+		template <class ComponentType, class LocatorType>
+		typename SpatialIndex<ComponentType, LocatorType>::Coordinates SpatialIndex<ComponentType, LocatorType>::coordinates_of(const Point& location) const {
+			return Coordinates {
+				static_cast<int>(std::floor(location.x / cell_size)),
+				static_cast<int>(std::floor(location.y / cell_size)),
+				static_cast<int>(std::floor(location.z / cell_size))
+			};
+		}
+
+		// packs the cell coordinates into 21 bits each
+		template <class ComponentType, class LocatorType>
+		typename SpatialIndex<ComponentType, LocatorType>::Cell SpatialIndex<ComponentType, LocatorType>::cell_at(int x, int y, int z) {
+			const Cell mask = (Cell(1) << 21) - 1;
+			return ((Cell(x) & mask) << 42) | ((Cell(y) & mask) << 21) | (Cell(z) & mask);
+		}
+
+		template <class ComponentType, class LocatorType>
+		float SpatialIndex<ComponentType, LocatorType>::distance_squared(const Point& a, const Point& b) {
+			float x = a.x - b.x, y = a.y - b.y, z = a.z - b.z;
+			return x * x + y * y + z * z;
+		}
+
+		// visits the entries of all occupied cells within the given coordinates (iterates the smaller of range and occupied cells)
+		template <class ComponentType, class LocatorType>
+		template <class Function>
+		void SpatialIndex<ComponentType, LocatorType>::for_each_entry(const Coordinates& minimum, const Coordinates& maximum, Function function) const {
+			double range = double(maximum.x - minimum.x + 1) * double(maximum.y - minimum.y + 1) * double(maximum.z - minimum.z + 1);
+			if (range > cells.size()) {
+				for (auto& cell : cells) {
+					for (auto& entry : cell.second) function(entry);
+				}
+				return;
+			}
+			for (int x = minimum.x; x <= maximum.x; ++x) {
+				for (int y = minimum.y; y <= maximum.y; ++y) {
+					for (int z = minimum.z; z <= maximum.z; ++z) {
+						auto iterator = cells.find(cell_at(x, y, z));
+						if (iterator == cells.end()) continue;
+						for (auto& entry : iterator->second) function(entry);
+					}
+				}
+			}
+		}
+
+		template <class ComponentType, class LocatorType>
+		void SpatialIndex<ComponentType, LocatorType>::attach(const Entity& entity, std::true_type observable) {
+			entity.get<ComponentType>().attach(this, entity);
+		}
+
+		template <class ComponentType, class LocatorType>
+		void SpatialIndex<ComponentType, LocatorType>::detach(const Entity& entity, std::true_type observable) {
+			entity.get<ComponentType>().detach(this, entity);
+		}
+
+	}
+
+}
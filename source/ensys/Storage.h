@@ -0,0 +1,60 @@
+#pragma once
+
+#include <ensys/Entity.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// base of stores owned by a world, which keep per entity data beside the component map
+		class Storage {
+
+		public:
+
+			Storage() = default;
+
+			Storage(const Storage&) = delete;
+			Storage(Storage&&) = delete;
+
+			Storage& operator=(const Storage&) = delete;
+			Storage& operator=(Storage&&) = delete;
+
+			virtual ~Storage() noexcept {}
+
+			// checks whether this storage holds data of the entity with the given id
+			virtual bool contains(Entity::Id id) const = 0;
+
+			// inserts the types stored for the entity with the given id into the given type set
+			virtual void collect(Entity::Id id, Types& types) const = 0;
+
+			// releases the data stored for the entity with the given id
+			virtual void release(Entity::Id id) = 0;
+
+			// releases the data of all entities
+			virtual void clear() = 0;
+
+			// moves the data stored for the entity with the given id to another (unused) id
+			virtual void renumber(Entity::Id from, Entity::Id to) = 0;
+
+			// releases memory kept from peak usage
+			virtual void shrink() {}
+
+			// moves the data of the entity with the given id, which gets deactivated cold, out of the way of iteration,
+			// returns whether there was data to move (the data stays accessible and part of the type signature)
+			virtual bool freeze(Entity::Id id) { return false; }
+
+			// moves the data of the entity with the given id, which gets activated, back in place
+			virtual void thaw(Entity::Id id) {}
+
+			// returns the approximate memory held by the data of cold entities in bytes
+			virtual size_t get_number_of_cold_bytes() const { return 0; }
+
+		};
+
+		using Storages = Map<Type, unique<Storage>>;
+
+	}
+
+}
@@ -8,7 +8,9 @@ namespace tenjix {
 
 	namespace ensys {
 
-		System::System(Priority priority) : priority(priority) {
+		constexpr uint System::Number_Of_Stages;
+
+		System::System(Priority priority, UpdateStage stage) : priority(priority), stage(stage) {
 			trace("constructing system");
 			is_initialized.owner = this;
 			is_active.owner = this;
@@ -19,50 +21,28 @@ namespace tenjix {
 		}
 
 		void System::update(float delta_time) {
-			auto iterator = suitable_entities.begin();
-			while (iterator != suitable_entities.end()) {
+			if (group == nullptr) return;
+			auto& entities = group->entities;
+			auto iterator = entities.begin();
+			while (iterator != entities.end()) {
 				Entity entity = *iterator++;
-				update(entity, delta_time);
-			}
-		}
-
-		void System::check(const Entity& entity) {
-			trace(*this, " check ", entity);
-			if (not entity.is_active) {
-				remove(entity);
-				return;
-			}
-			if (filter.accepts(entity.get_component_types())) {
-				add(entity);
-			} else {
-				remove(entity);
-			}
-		}
-
-		void System::add(const Entity& entity) {
-			if (suitable_entities.insert(entity).second) {
-				trace("adding ", entity, " to ", *this);
-				on_entity_added(entity);
-			}
-		}
-
-		void System::remove(const Entity& entity) {
-			if (suitable_entities.erase(entity)) {
-				trace("removing ", entity, " from ", *this);
-				on_entity_removed(entity);
+				if (world->is_enabled(entity.id)) update(entity, delta_time);
 			}
 		}
 
 		void System::activate() {
 			active = true;
+			if (world) world->schedule.compiled = false;
 		}
 
 		void System::deactivate() {
 			active = false;
+			if (world) world->schedule.compiled = false;
 		}
 
 		const Entities& System::get_entities() const {
-			return suitable_entities;
+			static const Entities no_entities;
+			return group ? group->entities : no_entities;
 		}
 
 		const TypeFilter& System::get_filter() const {
@@ -70,17 +50,7 @@ namespace tenjix {
 		}
 
 		uint System::get_number_of_entities() const {
-			return suitable_entities.size();
-		}
-
-		void System::remove_all_entities() {
-			auto iterator = suitable_entities.begin();
-			while (iterator != suitable_entities.end()) {
-				Entity entity = *iterator++;
-				trace("removing ", entity, " from ", *this);
-				suitable_entities.erase(iterator);
-				on_entity_removed(entity);
-			}
+			return group ? group->entities.size() : 0;
 		}
 
 		std::ostream& operator<<(std::ostream& output, const System& system) {
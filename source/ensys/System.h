@@ -3,6 +3,8 @@
 #include <iostream>
 
 #include <ensys/Entity.h>
+#include <ensys/Filter.h>
+#include <ensys/Group.h>
 
 #include <utilities/Properties.h>
 #include <utilities/Types.h>
@@ -25,11 +27,26 @@ namespace tenjix {
 
 			using Priority = unsigned char;
 
-			// the systems priority (systems with higher priority get updated first, but the order of systems with same priority is undefined)
+			// the stages of a world update, each followed by a sync point
+			enum class UpdateStage : unsigned char {
+				Pre_Update,
+				// runs once per fixed time step of the world (or once per update without a fixed time step)
+				Fixed_Update,
+				Update,
+				Post_Update,
+			};
+
+			static constexpr uint Number_Of_Stages = 4;
+
+			// the systems priority (systems with higher priority get updated first, systems with same priority in the order they were added)
 			const Priority priority;
 
-			// constructs a new system with the given priority (systems with higher priority get updated first, but the order of systems with same priority is undefined)
-			explicit System(Priority priority = 0);
+			// the stage this system gets updated in
+			const UpdateStage stage;
+
+			// constructs a new system with the given priority, updated in the given stage
+			// (systems with higher priority get updated first, systems with same priority in the order they were added)
+			explicit System(Priority priority = 0, UpdateStage stage = UpdateStage::Update);
 
 			System(const System&) = delete;
 			System(System&&) = delete;
@@ -67,27 +84,17 @@ namespace tenjix {
 		protected:
 
 			// the systems component type filter
-			TypeFilter filter;
+			Filter filter;
 
 			// updates the system
 			// invoked by the world.update(delta time)
-			// default implementation invokes system.update(entity, delta_time) for each entity in the system
+			// default implementation invokes system.update(entity, delta_time) for each enabled entity in the system
 			virtual void update(float delta_time);
 
 		private:
 
-			Entities suitable_entities;
-
-			// checks whether the given entity should be added to or removed from the system and acts accordingly
-			void check(const Entity& entity);
-
-			// adds an entity to the system and invokes on_entity_added
-			void add(const Entity& entity);
-			// removes an entity from the system and invokes on_entity_added
-			void remove(const Entity& entity);
-
-			// removes all entities from the system and invokes on_entity_removed accordingly
-			void remove_all_entities();
+			// the group of entities accepted by the systems filter, shared with all systems with an equal filter
+			Group* group = nullptr;
 
 			// initializes the system
 			// invoked after the system has been added to a world
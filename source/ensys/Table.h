@@ -0,0 +1,507 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <tuple>
+#include <type_traits>
+
+#include <ensys/Component.h>
+#include <ensys/IDs.h>
+#include <ensys/Span.h>
+#include <ensys/Storage.h>
+
+#include <utilities/Assertions.h>
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// allocates the memory of table chunks
+		class ChunkAllocator {
+
+		public:
+
+			virtual ~ChunkAllocator() noexcept {}
+
+			// allocates a chunk of the given size, aligned to the given alignment
+			virtual void* allocate(size_t size, size_t alignment) = 0;
+
+			// releases a chunk allocated with the given size
+			virtual void deallocate(void* chunk, size_t size) = 0;
+
+			// appends the chunks of the given size persisted by an earlier session in allocation order, returns their number
+			virtual uint restore(size_t size, Lot<void*>& chunks) { return 0; }
+
+			// checks whether allocated chunks outlive their tables (which then keep them on destruction)
+			virtual bool is_persistent() const { return false; }
+
+			// hints that the given chunk is about to be accessed
+			virtual void prefetch(void* chunk, size_t size) {}
+
+			// hints that the given chunk won't be accessed for a while and may be paged out
+			virtual void evict(void* chunk, size_t size) {}
+
+		};
+
+		// allocates table chunks on the heap
+		class HeapChunkAllocator final : public ChunkAllocator {
+
+		public:
+
+			// returns the allocator shared by all tables using the heap
+			static HeapChunkAllocator& instance() {
+				static HeapChunkAllocator allocator;
+				return allocator;
+			}
+
+			// over allocates and stores the offset to the allocated block in front of the aligned chunk
+			void* allocate(size_t size, size_t alignment) override {
+				char* block = static_cast<char*>(std::malloc(size + alignment + sizeof(void*)));
+				if (block == nullptr) throw std::bad_alloc();
+				size_t address = reinterpret_cast<size_t>(block + sizeof(void*));
+				char* chunk = reinterpret_cast<char*>((address + alignment - 1) / alignment * alignment);
+				reinterpret_cast<void**>(chunk)[-1] = block;
+				return chunk;
+			}
+
+			void deallocate(void* chunk, size_t size) override {
+				std::free(reinterpret_cast<void**>(chunk)[-1]);
+			}
+
+		};
+
+		// checks whether the given types are plain components (trivially copyable and not derived from Component)
+		template <class... ComponentTypes>
+		struct is_plain;
+
+		template <>
+		struct is_plain<> : std::true_type {};
+
+		template <class ComponentType, class... ComponentTypes>
+		struct is_plain<ComponentType, ComponentTypes...> : std::integral_constant<bool,
+			std::is_trivially_copyable<ComponentType>::value and not std::is_base_of<Component, ComponentType>::value and is_plain<ComponentTypes...>::value
+		> {};
+
+		// stores plain components (trivially copyable, without Component base or vtable) of the given types,
+		// structure of arrays in fixed size chunks: each chunk holds an aligned array per component type,
+		// so systems can process whole chunks with vectorized kernels through for_each_chunk
+		// (columns are split by component type, not by field: a kernel wanting one lane per field declares a plain type per field,
+		// a column of a multi field type like { float x, y, z; } is a packed float array, which kernels can also stream over)
+		template <class... ComponentTypes>
+		class Table final : public Storage {
+
+		public:
+
+			// the number of entities per chunk
+			static constexpr uint Chunk_Capacity = 256;
+			// the alignment of the component arrays within each chunk (a cache line, covers AVX registers)
+			static constexpr size_t Alignment = 64;
+
+		private:
+
+			using Columns = std::tuple<ComponentTypes*...>;
+
+			struct Chunk {
+				void* memory;
+				Entity::Id* ids;
+				Columns columns;
+			};
+
+			ChunkAllocator& allocator;
+
+			Lot<Chunk> chunks;
+			// the row of each entity (chunk * capacity + index)
+			Map<Entity::Id, uint> rows;
+			// the number of rows, rows are packed without holes
+			uint number_of_rows = 0;
+
+			// the rows of cold entities, packed on the heap apart from the chunks, so iterating the chunks skips them
+			std::tuple<Lot<ComponentTypes>...> cold_columns;
+			Lot<Entity::Id> cold_ids;
+			// the index of each cold row
+			Map<Entity::Id, uint> cold_rows;
+
+		public:
+
+			// restores the rows persisted by the given allocator
+			explicit Table(ChunkAllocator& allocator = HeapChunkAllocator::instance());
+
+			~Table() noexcept;
+
+			// inserts a row with the given components for the entity with the given id
+			void insert(Entity::Id id, const ComponentTypes&... components);
+
+			// erases the row of the entity with the given id, moving the last row into its place
+			void erase(Entity::Id id);
+
+			// returns the component of the given type of the entity with the given id (whose row may be cold)
+			template <class ComponentType>
+			ComponentType& get(Entity::Id id);
+
+			// returns the component of the given type of the entity with the given id
+			template <class ComponentType>
+			const ComponentType& get(Entity::Id id) const;
+
+			// invokes the given function for each chunk with spans of its ids and its components of each type
+			template <class Function>
+			void for_each_chunk(Function function);
+
+			// returns the ids of the entities in the given chunk
+			Span<const Entity::Id> get_ids(uint chunk) const;
+
+			// returns the components of the given type in the given chunk
+			template <class ComponentType>
+			Span<ComponentType> get_column(uint chunk);
+
+			// hints that the given chunks are about to be iterated, so their pages can be read ahead
+			void prefetch(uint first_chunk, uint number_of_chunks = 1);
+
+			// hints that the given chunks won't be iterated for a while, so their pages can be written back and dropped
+			void evict(uint first_chunk, uint number_of_chunks = 1);
+
+			// returns the number of chunks holding rows
+			uint get_number_of_chunks() const;
+
+			// returns the number of rows (entities) in this table, without the rows of cold entities
+			uint get_number_of_rows() const;
+
+			// returns the number of rows of cold entities
+			uint get_number_of_cold_rows() const;
+
+			// returns the size of a chunk in bytes
+			static size_t get_chunk_size();
+
+			bool contains(Entity::Id id) const override;
+			void collect(Entity::Id id, Types& types) const override;
+			void release(Entity::Id id) override;
+			void clear() override;
+			void renumber(Entity::Id from, Entity::Id to) override;
+			void shrink() override;
+
+			// moves the row into the cold rows, rows of persistent tables stay in their chunks so they outlive the session
+			bool freeze(Entity::Id id) override;
+			void thaw(Entity::Id id) override;
+			size_t get_number_of_cold_bytes() const override;
+
+		private:
+
+			static size_t align(size_t size);
+
+			template <class ComponentType>
+			static ComponentType* place(char* memory, size_t& offset);
+
+			Chunk open(void* memory) const;
+
+			uint get_size(uint chunk) const;
+
+			void copy(uint source, uint target);
+
+			// erases the given cold row, moving the last cold row into its place
+			void erase_cold(uint row);
+
+			template <class ComponentType>
+			void copy_cold(uint source, uint target);
+
+		};
+
+		// unused id slots hold no id, so the rows of restored chunks are the leading slots holding ids
+		template <class... ComponentTypes>
+		Table<ComponentTypes...>::Table(ChunkAllocator& allocator) : allocator(allocator) {
+			static_assert(sizeof...(ComponentTypes) > 0, "a table needs at least one component type");
+			static_assert(is_plain<ComponentTypes...>(), "plain components have to be trivially copyable and can't be derived from Component");
+			Lot<void*> restored;
+			allocator.restore(get_chunk_size(), restored);
+			for (void* memory : restored) {
+				chunks.push_back(open(memory));
+				Chunk& chunk = chunks.back();
+				for (uint index = 0; index < Chunk_Capacity and chunk.ids[index] != IDs::No_Id; ++index) {
+					rows.emplace(chunk.ids[index], number_of_rows++);
+				}
+			}
+		}
+
+		template <class... ComponentTypes>
+		Table<ComponentTypes...>::~Table() noexcept {
+			if (allocator.is_persistent()) return;
+			clear();
+		}
+
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::insert(Entity::Id id, const ComponentTypes&... components) {
+			runtime_assert(not contains(id), "entity #", id, " already has a row in this table, can't insert another");
+			uint row = number_of_rows;
+			if (row == chunks.size() * Chunk_Capacity) {
+				chunks.push_back(open(allocator.allocate(get_chunk_size(), Alignment)));
+				std::fill(chunks.back().ids, chunks.back().ids + Chunk_Capacity, IDs::No_Id);
+			}
+			Chunk& chunk = chunks[row / Chunk_Capacity];
+			uint index = row % Chunk_Capacity;
+			chunk.ids[index] = id;
+			for_each_variadic(new (std::get<ComponentTypes*>(chunk.columns) + index) ComponentTypes(components));
+			rows.emplace(id, row);
+			number_of_rows++;
+		}
+
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::erase(Entity::Id id) {
+			auto iterator = rows.find(id);
+			runtime_assert(iterator != rows.end(), "entity #", id, " doesn't have a row in this table, can't erase it");
+			uint row = iterator->second;
+			rows.erase(iterator);
+			uint last = --number_of_rows;
+			if (row != last) {
+				copy(last, row);
+				rows[chunks[row / Chunk_Capacity].ids[row % Chunk_Capacity]] = row;
+			}
+			chunks[last / Chunk_Capacity].ids[last % Chunk_Capacity] = IDs::No_Id;
+			// keeps one empty chunk to avoid reallocating at the chunk border
+			while (chunks.size() > 1 and (chunks.size() - 1) * Chunk_Capacity >= number_of_rows + Chunk_Capacity) {
+				allocator.deallocate(chunks.back().memory, get_chunk_size());
+				chunks.pop_back();
+			}
+		}
+
+		template <class... ComponentTypes>
+		template <class ComponentType>
+		ComponentType& Table<ComponentTypes...>::get(Entity::Id id) {
+			auto iterator = rows.find(id);
+			if (iterator == rows.end()) {
+				auto cold = cold_rows.find(id);
+				runtime_assert(cold != cold_rows.end(), "entity #", id, " doesn't have a row in this table, can't access ", Type(typeid(ComponentType)));
+				return std::get<Lot<ComponentType>>(cold_columns)[cold->second];
+			}
+			uint row = iterator->second;
+			return std::get<ComponentType*>(chunks[row / Chunk_Capacity].columns)[row % Chunk_Capacity];
+		}
+
+		template <class... ComponentTypes>
+		template <class ComponentType>
+		const ComponentType& Table<ComponentTypes...>::get(Entity::Id id) const {
+			return const_cast<Table&>(*this).get<ComponentType>(id);
+		}
+
+		// invokes the given function for each chunk with spans of its ids and its components of each type
+		// e.g. table.for_each_chunk([&](Span<const Entity::Id> ids, Span<Position> positions, Span<Velocity> velocities) { ... })
+		template <class... ComponentTypes>
+		template <class Function>
+		void Table<ComponentTypes...>::for_each_chunk(Function function) {
+			for (uint chunk = 0; chunk < chunks.size(); ++chunk) {
+				uint size = get_size(chunk);
+				if (size == 0) break;
+				Chunk& data = chunks[chunk];
+				function(Span<const Entity::Id>(data.ids, size), Span<ComponentTypes>(std::get<ComponentTypes*>(data.columns), size)...);
+			}
+		}
+
+		template <class... ComponentTypes>
+		Span<const Entity::Id> Table<ComponentTypes...>::get_ids(uint chunk) const {
+			return Span<const Entity::Id>(chunks.at(chunk).ids, get_size(chunk));
+		}
+
+		template <class... ComponentTypes>
+		template <class ComponentType>
+		Span<ComponentType> Table<ComponentTypes...>::get_column(uint chunk) {
+			return Span<ComponentType>(std::get<ComponentType*>(chunks.at(chunk).columns), get_size(chunk));
+		}
+
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::prefetch(uint first_chunk, uint number_of_chunks) {
+			for (uint chunk = first_chunk; chunk < first_chunk + number_of_chunks and chunk < chunks.size(); ++chunk) {
+				allocator.prefetch(chunks[chunk].memory, get_chunk_size());
+			}
+		}
+
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::evict(uint first_chunk, uint number_of_chunks) {
+			for (uint chunk = first_chunk; chunk < first_chunk + number_of_chunks and chunk < chunks.size(); ++chunk) {
+				allocator.evict(chunks[chunk].memory, get_chunk_size());
+			}
+		}
+
+		template <class... ComponentTypes>
+		uint Table<ComponentTypes...>::get_number_of_chunks() const {
+			return (number_of_rows + Chunk_Capacity - 1) / Chunk_Capacity;
+		}
+
+		template <class... ComponentTypes>
+		uint Table<ComponentTypes...>::get_number_of_rows() const {
+			return number_of_rows;
+		}
+
+		template <class... ComponentTypes>
+		uint Table<ComponentTypes...>::get_number_of_cold_rows() const {
+			return cold_ids.size();
+		}
+
+		// the chunk layout: ids followed by one array per component type, each aligned
+		template <class... ComponentTypes>
+		size_t Table<ComponentTypes...>::get_chunk_size() {
+			size_t sizes[] = { align(sizeof(ComponentTypes) * Chunk_Capacity)... };
+			size_t size = align(sizeof(Entity::Id) * Chunk_Capacity);
+			for (size_t column_size : sizes) size += column_size;
+			return size;
+		}
+
+		template <class... ComponentTypes>
+		bool Table<ComponentTypes...>::contains(Entity::Id id) const {
+			return rows.find(id) != rows.end() or cold_rows.find(id) != cold_rows.end();
+		}
+
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::collect(Entity::Id id, Types& types) const {
+			if (not contains(id)) return;
+			for_each_variadic(types.insert(typeid(ComponentTypes)));
+		}
+
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::release(Entity::Id id) {
+			auto cold = cold_rows.find(id);
+			if (cold != cold_rows.end()) {
+				uint row = cold->second;
+				cold_rows.erase(cold);
+				erase_cold(row);
+			} else if (contains(id)) {
+				erase(id);
+			}
+		}
+
+		// releases the chunks in reverse allocation order
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::clear() {
+			for (auto chunk = chunks.rbegin(); chunk != chunks.rend(); ++chunk) {
+				allocator.deallocate(chunk->memory, get_chunk_size());
+			}
+			chunks.clear();
+			rows.clear();
+			number_of_rows = 0;
+			cold_columns = std::tuple<Lot<ComponentTypes>...>();
+			cold_ids.clear();
+			cold_rows.clear();
+		}
+
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::renumber(Entity::Id from, Entity::Id to) {
+			auto cold = cold_rows.find(from);
+			if (cold != cold_rows.end()) {
+				uint row = cold->second;
+				cold_rows.erase(cold);
+				cold_rows.emplace(to, row);
+				cold_ids[row] = to;
+				return;
+			}
+			auto iterator = rows.find(from);
+			if (iterator == rows.end()) return;
+			uint row = iterator->second;
+			rows.erase(iterator);
+			rows.emplace(to, row);
+			chunks[row / Chunk_Capacity].ids[row % Chunk_Capacity] = to;
+		}
+
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::shrink() {
+			rows.rehash(0);
+			chunks.shrink_to_fit();
+			cold_rows.rehash(0);
+			cold_ids.shrink_to_fit();
+			for_each_variadic(std::get<Lot<ComponentTypes>>(cold_columns).shrink_to_fit());
+		}
+
+		// swap removes the row from the chunks, so the chunks stay packed with the rows of active entities
+		template <class... ComponentTypes>
+		bool Table<ComponentTypes...>::freeze(Entity::Id id) {
+			if (allocator.is_persistent()) return false;
+			auto iterator = rows.find(id);
+			if (iterator == rows.end()) return false;
+			uint row = iterator->second;
+			Chunk& chunk = chunks[row / Chunk_Capacity];
+			uint index = row % Chunk_Capacity;
+			cold_rows.emplace(id, cold_ids.size());
+			cold_ids.push_back(id);
+			for_each_variadic(std::get<Lot<ComponentTypes>>(cold_columns).push_back(std::get<ComponentTypes*>(chunk.columns)[index]));
+			erase(id);
+			return true;
+		}
+
+		// appends the row to the chunks again
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::thaw(Entity::Id id) {
+			auto cold = cold_rows.find(id);
+			if (cold == cold_rows.end()) return;
+			uint row = cold->second;
+			cold_rows.erase(cold);
+			insert(id, std::get<Lot<ComponentTypes>>(cold_columns)[row]...);
+			erase_cold(row);
+		}
+
+		template <class... ComponentTypes>
+		size_t Table<ComponentTypes...>::get_number_of_cold_bytes() const {
+			size_t sizes[] = { std::get<Lot<ComponentTypes>>(cold_columns).capacity() * sizeof(ComponentTypes)... };
+			size_t bytes = cold_ids.capacity() * sizeof(Entity::Id) + cold_rows.bucket_count() * sizeof(void*);
+			bytes += cold_rows.size() * (sizeof(typename Map<Entity::Id, uint>::value_type) + sizeof(void*));
+			for (size_t size : sizes) bytes += size;
+			return bytes;
+		}
+
+		template <class... ComponentTypes>
+		size_t Table<ComponentTypes...>::align(size_t size) {
+			return (size + Alignment - 1) / Alignment * Alignment;
+		}
+
+		template <class... ComponentTypes>
+		template <class ComponentType>
+		ComponentType* Table<ComponentTypes...>::place(char* memory, size_t& offset) {
+			ComponentType* column = reinterpret_cast<ComponentType*>(memory + offset);
+			offset += align(sizeof(ComponentType) * Chunk_Capacity);
+			return column;
+		}
+
+		template <class... ComponentTypes>
+		typename Table<ComponentTypes...>::Chunk Table<ComponentTypes...>::open(void* memory) const {
+			char* bytes = static_cast<char*>(memory);
+			size_t offset = align(sizeof(Entity::Id) * Chunk_Capacity);
+			return Chunk { memory, reinterpret_cast<Entity::Id*>(bytes), Columns { place<ComponentTypes>(bytes, offset)... } };
+		}
+
+		template <class... ComponentTypes>
+		uint Table<ComponentTypes...>::get_size(uint chunk) const {
+			uint begin = chunk * Chunk_Capacity;
+			if (begin >= number_of_rows) return 0;
+			uint size = number_of_rows - begin;
+			return size < Chunk_Capacity ? size : Chunk_Capacity;
+		}
+
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::copy(uint source, uint target) {
+			Chunk& from = chunks[source / Chunk_Capacity];
+			Chunk& to = chunks[target / Chunk_Capacity];
+			uint i = source % Chunk_Capacity;
+			uint j = target % Chunk_Capacity;
+			to.ids[j] = from.ids[i];
+			for_each_variadic(std::memcpy(std::get<ComponentTypes*>(to.columns) + j, std::get<ComponentTypes*>(from.columns) + i, sizeof(ComponentTypes)));
+		}
+
+		template <class... ComponentTypes>
+		void Table<ComponentTypes...>::erase_cold(uint row) {
+			uint last = cold_ids.size() - 1;
+			if (row != last) {
+				cold_ids[row] = cold_ids[last];
+				cold_rows[cold_ids[row]] = row;
+				for_each_variadic(copy_cold<ComponentTypes>(last, row));
+			}
+			cold_ids.pop_back();
+			for_each_variadic(std::get<Lot<ComponentTypes>>(cold_columns).pop_back());
+		}
+
+		template <class... ComponentTypes>
+		template <class ComponentType>
+		void Table<ComponentTypes...>::copy_cold(uint source, uint target) {
+			Lot<ComponentType>& column = std::get<Lot<ComponentType>>(cold_columns);
+			std::memcpy(&column[target], &column[source], sizeof(ComponentType));
+		}
+
+	}
+
+}
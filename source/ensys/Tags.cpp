@@ -0,0 +1,53 @@
+#include "Tags.h"
+
+namespace tenjix {
+
+	namespace ensys {
+
+		constexpr uint Tags::Max_Tags;
+
+		bool Tags::has_all(Entity::Id entity, Mask mask) const {
+			return entity < masks.size() and (masks[entity] & mask) == mask;
+		}
+
+		Tags::Mask Tags::get_mask(Entity::Id entity) const {
+			return entity < masks.size() ? masks[entity] : 0;
+		}
+
+		bool Tags::contains(Entity::Id entity) const {
+			return get_mask(entity) != 0;
+		}
+
+		// inserts the type of each set bit, so tags take part in system filters
+		void Tags::collect(Entity::Id entity, Types& types) const {
+			Mask mask = get_mask(entity);
+			for (uint bit = 0; mask; ++bit, mask >>= 1) {
+				if (mask & 1) types.insert(*this->types[bit]);
+			}
+		}
+
+		void Tags::release(Entity::Id entity) {
+			if (entity < masks.size()) masks[entity] = 0;
+		}
+
+		void Tags::clear() {
+			masks.clear();
+		}
+
+		void Tags::renumber(Entity::Id from, Entity::Id to) {
+			Mask mask = get_mask(from);
+			release(from);
+			if (not mask) return;
+			if (to >= masks.size()) masks.resize(to + 1, 0);
+			masks[to] = mask;
+		}
+
+		// drops trailing entities without tags
+		void Tags::shrink() {
+			while (not masks.empty() and masks.back() == 0) masks.pop_back();
+			masks.shrink_to_fit();
+		}
+
+	}
+
+}
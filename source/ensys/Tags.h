@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <typeinfo>
+
+#include <ensys/Component.h>
+#include <ensys/Entity.h>
+#include <ensys/Storage.h>
+#include <ensys/TypeIndex.h>
+
+#include <utilities/Assertions.h>
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// the tag components of each entity, kept as one bit per tag type instead of a component instance
+		// tags take part in system filters like components, but cost no allocation and no map entry
+		class Tags final : public Storage {
+
+		public:
+
+			using Mask = uint64_t;
+
+			// the maximum number of tag types per program (not per world)
+			static constexpr uint Max_Tags = 64;
+
+		private:
+
+			// tag masks indexed by entity id
+			Lot<Mask> masks;
+
+			// tag types indexed by bit
+			Lot<const std::type_info*> types;
+
+		public:
+
+			// returns the bit of a tag type, bits are assigned on first use within the program and shared by all worlds,
+			// so a program can use at most Max_Tags tag types in total
+			template <class TagType>
+			static Mask bit_of();
+
+			// sets the tag of the given type on the entity with the given id
+			template <class TagType>
+			void add(Entity::Id entity);
+
+			// clears the tag of the given type on the entity with the given id
+			template <class TagType>
+			void remove(Entity::Id entity);
+
+			// checks whether the entity with the given id is tagged with the given type
+			template <class TagType>
+			bool has(Entity::Id entity) const;
+
+			// checks whether the entity with the given id carries all tags of the given mask
+			bool has_all(Entity::Id entity, Mask mask) const;
+
+			// returns the tag mask of the entity with the given id
+			Mask get_mask(Entity::Id entity) const;
+
+			bool contains(Entity::Id entity) const override;
+			void collect(Entity::Id entity, Types& types) const override;
+			void release(Entity::Id entity) override;
+			void clear() override;
+			void renumber(Entity::Id from, Entity::Id to) override;
+			void shrink() override;
+
+		};
+
+		// returns the bit of a tag type, bits are assigned on first use within the program and shared by all worlds,
+		// so a program can use at most Max_Tags tag types in total
+		template <class TagType>
+		Tags::Mask Tags::bit_of() {
+			static_assert(is_tag<TagType>(), "given type is not a tag, can't store it as bit");
+			uint index = TypeIndex<Tag>::of<TagType>();
+			runtime_assert(index < Max_Tags, "there are more than ", Max_Tags, " tag types, can't assign a bit to ", Type(typeid(TagType)));
+			return Mask(1) << index;
+		}
+
+		// sets the tag of the given type on the entity with the given id, registering the type of its bit
+		template <class TagType>
+		void Tags::add(Entity::Id entity) {
+			uint index = TypeIndex<Tag>::of<TagType>();
+			Mask bit = bit_of<TagType>();
+			if (index >= types.size()) types.resize(index + 1, nullptr);
+			types[index] = &typeid(TagType);
+			if (entity >= masks.size()) masks.resize(entity + 1, 0);
+			masks[entity] |= bit;
+		}
+
+		// clears the tag of the given type on the entity with the given id
+		template <class TagType>
+		void Tags::remove(Entity::Id entity) {
+			if (entity < masks.size()) masks[entity] &= ~bit_of<TagType>();
+		}
+
+		// checks whether the entity with the given id is tagged with the given type
+		template <class TagType>
+		bool Tags::has(Entity::Id entity) const {
+			return has_all(entity, bit_of<TagType>());
+		}
+
+	}
+
+}
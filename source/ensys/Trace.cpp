@@ -0,0 +1,185 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		namespace {
+
+			const char Magic[4] = { 'E', 'T', 'R', 'C' };
+			const uint32_t Version = 1;
+
+		}
+
+		TraceBuffer::TraceBuffer(uint32_t thread) : thread(thread) {}
+
+		struct TraceBuffer::Retirement {
+			TraceBuffer* buffer = nullptr;
+			~Retirement() {
+				if (buffer) retire(*buffer);
+			}
+		};
+
+		// registers the buffer once per thread, afterwards recording takes no locks
+		TraceBuffer& TraceBuffer::local() {
+			static std::atomic<uint32_t> threads(0);
+			thread_local Retirement retirement;
+			if (retirement.buffer == nullptr) {
+				std::lock_guard<std::mutex> lock(Trace::registry_mutex());
+				auto& registry = Trace::registry();
+				registry.push_back(std::make_shared<TraceBuffer>(threads++));
+				retirement.buffer = registry.back().get();
+			}
+			return *retirement.buffer;
+		}
+
+		void TraceBuffer::retire(TraceBuffer& buffer) {
+			std::lock_guard<std::mutex> lock(Trace::registry_mutex());
+			auto& retired = Trace::retired();
+			buffer.collect(retired);
+			if (retired.size() > Capacity) retired.erase(retired.begin(), retired.end() - Capacity);
+			auto& registry = Trace::registry();
+			registry.erase(std::remove_if(registry.begin(), registry.end(), [&buffer](const shared<TraceBuffer>& registered) {
+				return registered.get() == &buffer;
+			}), registry.end());
+		}
+
+		void TraceBuffer::record(TraceEvent event, uint64_t first, uint64_t second) {
+			uint64_t index = head.load(std::memory_order_relaxed);
+			TraceRecord record;
+			record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			record.first = first;
+			record.second = second;
+			record.thread = thread;
+			record.event = event;
+			record.reserved = 0;
+			uint64_t words[sizeof(TraceRecord) / sizeof(uint64_t)];
+			std::memcpy(words, &record, sizeof(TraceRecord));
+			// orders the slot writes after the publication of the previous record, for the check in collect
+			std::atomic_thread_fence(std::memory_order_release);
+			Slot& slot = records[index % Capacity];
+			for (uint i = 0; i < sizeof(TraceRecord) / sizeof(uint64_t); ++i) {
+				slot.words[i].store(words[i], std::memory_order_relaxed);
+			}
+			head.store(index + 1, std::memory_order_release);
+		}
+
+		// copies the retained range, then drops the records the owner may have overwritten meanwhile,
+		// including the slot of the record the owner may be writing (the one after the last published record)
+		uint TraceBuffer::collect(Lot<TraceRecord>& result) const {
+			uint64_t end = head.load(std::memory_order_acquire);
+			uint64_t begin = end > Capacity ? end - Capacity : 0;
+			Lot<TraceRecord> copied;
+			copied.reserve(end - begin);
+			for (uint64_t index = begin; index < end; ++index) {
+				const Slot& slot = records[index % Capacity];
+				uint64_t words[sizeof(TraceRecord) / sizeof(uint64_t)];
+				for (uint i = 0; i < sizeof(TraceRecord) / sizeof(uint64_t); ++i) {
+					words[i] = slot.words[i].load(std::memory_order_relaxed);
+				}
+				copied.emplace_back();
+				std::memcpy(&copied.back(), words, sizeof(TraceRecord));
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			uint64_t overwritten = head.load(std::memory_order_relaxed) + 1;
+			uint64_t valid = overwritten > Capacity ? overwritten - Capacity : 0;
+			uint64_t skipped = valid > begin ? std::min(valid - begin, end - begin) : 0;
+			result.insert(result.end(), copied.begin() + skipped, copied.end());
+			return copied.size() - skipped;
+		}
+
+		void Trace::dump(std::ostream& stream) {
+			Lot<TraceRecord> records;
+			{
+				std::lock_guard<std::mutex> lock(registry_mutex());
+				records = retired();
+				for (auto& buffer : registry()) {
+					buffer->collect(records);
+				}
+			}
+			uint64_t number_of_records = records.size();
+			stream.write(Magic, sizeof(Magic));
+			stream.write(reinterpret_cast<const char*>(&Version), sizeof(Version));
+			stream.write(reinterpret_cast<const char*>(&number_of_records), sizeof(number_of_records));
+			stream.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(TraceRecord));
+		}
+
+		uint Trace::load(std::istream& stream, Lot<TraceRecord>& records) {
+			char magic[sizeof(Magic)];
+			uint32_t version = 0;
+			uint64_t number_of_records = 0;
+			stream.read(magic, sizeof(magic));
+			stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+			stream.read(reinterpret_cast<char*>(&number_of_records), sizeof(number_of_records));
+			if (not stream or std::memcmp(magic, Magic, sizeof(Magic)) != 0 or version != Version) return 0;
+			uint offset = records.size();
+			records.resize(offset + number_of_records);
+			stream.read(reinterpret_cast<char*>(records.data() + offset), number_of_records * sizeof(TraceRecord));
+			uint number_of_read_records = stream.gcount() / sizeof(TraceRecord);
+			records.resize(offset + number_of_read_records);
+			return number_of_read_records;
+		}
+
+		void Trace::print(Lot<TraceRecord> records, std::ostream& stream) {
+			if (records.empty()) return;
+			std::stable_sort(records.begin(), records.end(), [](const TraceRecord& a, const TraceRecord& b) {
+				return a.time < b.time;
+			});
+			uint64_t start = records.front().time;
+			for (auto& record : records) {
+				stream << std::setw(12) << (record.time - start) << " ns  thread " << record.thread << "  " << name_of(record.event);
+				if (record.event == TraceEvent::Construct_Component or record.event == TraceEvent::Destruct_Component) {
+					stream << "  [0x" << std::hex << record.first << std::dec << "]\n";
+					continue;
+				}
+				stream << "  entity #" << record.first;
+				switch (record.event) {
+					case TraceEvent::Create_Entity:
+						stream << " with " << record.second << " components";
+						break;
+					case TraceEvent::Destroy_Entity:
+						break;
+					default:
+						stream << "  type " << std::hex << record.second << std::dec;
+				}
+				stream << '\n';
+			}
+		}
+
+		const char* Trace::name_of(TraceEvent event) {
+			switch (event) {
+				case TraceEvent::Create_Entity: return "create entity";
+				case TraceEvent::Destroy_Entity: return "destroy entity";
+				case TraceEvent::Add_Component: return "add component";
+				case TraceEvent::Remove_Component: return "remove component";
+				case TraceEvent::Add_To_System: return "add to system";
+				case TraceEvent::Remove_From_System: return "remove from system";
+				case TraceEvent::Construct_Component: return "construct component";
+				case TraceEvent::Destruct_Component: return "destruct component";
+			}
+			return "unknown";
+		}
+
+		std::mutex& Trace::registry_mutex() {
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		Lot<shared<TraceBuffer>>& Trace::registry() {
+			static Lot<shared<TraceBuffer>> buffers;
+			return buffers;
+		}
+
+		Lot<TraceRecord>& Trace::retired() {
+			static Lot<TraceRecord> records;
+			return records;
+		}
+
+	}
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <ostream>
+
+#include <utilities/Types.h>
+
+// the compile time trace level of the hot paths
+// 0 compiles the trace points away, 1 records binary trace events into per thread ring buffers
+#ifndef ENSYS_TRACE_LEVEL
+	#define ENSYS_TRACE_LEVEL 0
+#endif
+
+// records a binary trace event with two arguments into the ring buffer of the calling thread
+#if ENSYS_TRACE_LEVEL >= 1
+	#define ensys_trace(event, first, second) ::tenjix::ensys::TraceBuffer::local().record(::tenjix::ensys::TraceEvent::event, (first), (second))
+#else
+	#define ensys_trace(event, first, second) ((void) 0)
+#endif
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// the kinds of traced events, the meaning of the record arguments is given in brackets
+		enum class TraceEvent : uint16_t {
+			Create_Entity,       // [entity id, number of components]
+			Destroy_Entity,      // [entity id, 0]
+			Add_Component,       // [entity id, component type hash (table type hash for plain components)]
+			Remove_Component,    // [entity id, component type hash (table type hash for plain components)]
+			Add_To_System,       // [entity id, system type hash]
+			Remove_From_System,  // [entity id, system type hash]
+			Construct_Component, // [component address, 0]
+			Destruct_Component,  // [component address, 0]
+		};
+
+		// a fixed size trace record
+		struct TraceRecord {
+			// nanoseconds since the steady clock epoch
+			uint64_t time;
+			uint64_t first;
+			uint64_t second;
+			// the number of the recording thread
+			uint32_t thread;
+			TraceEvent event;
+			uint16_t reserved;
+		};
+
+		// a lock free ring buffer of trace records written by a single thread,
+		// the oldest records get overwritten once the buffer is full
+		class TraceBuffer final {
+
+		public:
+
+			static constexpr uint Capacity = 1 << 14;
+
+			// the number of the owning thread
+			const uint32_t thread;
+
+			explicit TraceBuffer(uint32_t thread);
+
+			// returns the buffer of the calling thread, registering it on first use
+			static TraceBuffer& local();
+
+			// records an event, only to be called by the owning thread
+			void record(TraceEvent event, uint64_t first, uint64_t second);
+
+			// appends the retained records in recording order to the result, returns their number
+			// records overwritten while collecting are dropped
+			uint collect(Lot<TraceRecord>& result) const;
+
+			// moves the records of the buffer of an exiting thread to the retired records and frees the buffer
+			static void retire(TraceBuffer& buffer);
+
+		private:
+
+			// retires the buffer of the calling thread when the thread exits
+			struct Retirement;
+
+			// a record stored as atomic words, so the collecting thread may read slots the owner overwrites meanwhile
+			struct Slot {
+				std::atomic<uint64_t> words[sizeof(TraceRecord) / sizeof(uint64_t)];
+			};
+
+			Slot records[Capacity];
+
+			// the total number of records ever recorded
+			std::atomic<uint64_t> head { 0 };
+
+		};
+
+		// collects the trace buffers of all threads and decodes dumped traces offline
+		class Trace final {
+
+		public:
+
+			// writes the records of all thread buffers in binary form
+			static void dump(std::ostream& stream);
+
+			// reads records written by dump, returns their number
+			static uint load(std::istream& stream, Lot<TraceRecord>& records);
+
+			// prints the records as a timeline ordered by time, relative to the first record
+			static void print(Lot<TraceRecord> records, std::ostream& stream);
+
+			// returns the name of an event
+			static const char* name_of(TraceEvent event);
+
+		private:
+
+			friend TraceBuffer;
+
+			// guards the registry, only locked when a thread records its first event and when dumping
+			static std::mutex& registry_mutex();
+
+			// the buffers of all running threads which recorded
+			static Lot<shared<TraceBuffer>>& registry();
+
+			// the latest records of exited threads (at most one buffer capacity), kept for dumping
+			static Lot<TraceRecord>& retired();
+
+		};
+
+	}
+
+}
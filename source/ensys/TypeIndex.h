@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// assigns dense indices to types, starting at zero for each family of types
+		// allows type indexed slot arrays with constant time access instead of type keyed maps
+		template <class Family>
+		class TypeIndex final {
+
+			static uint next() {
+				static std::atomic<uint> counter(0);
+				return counter++;
+			}
+
+		public:
+
+			TypeIndex() = delete;
+
+			// returns the index of the given type within the family
+			template <class IndexedType>
+			static uint of() {
+				static const uint index = next();
+				return index;
+			}
+
+		};
+
+	}
+
+}
@@ -1,5 +1,12 @@
 #include "World.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <typeinfo>
+
+#include <ensys/Trace.h>
+
 #include <utilities/Logging.h>
 #include <utilities/Strings.h>
 
@@ -9,43 +16,211 @@ namespace tenjix {
 
 		World::World(String name, uint initial_entity_pool_size) : name(name), entity_ids(initial_entity_pool_size) {}
 
+		struct World::Suspension {
+
+			World& world;
+			Recorder* const recorder;
+			Recorder* const spawn_recorder;
+
+			// the suspended recorder keeps getting the entities created and destroyed meanwhile if spawns is set
+			Suspension(World& world, bool spawns) : world(world), recorder(world.recorder), spawn_recorder(world.spawn_recorder) {
+				if (spawns and recorder) world.spawn_recorder = recorder;
+				world.recorder = nullptr;
+			}
+
+			~Suspension() {
+				world.recorder = recorder;
+				world.spawn_recorder = spawn_recorder;
+			}
+
+		};
+
+		// a replayed update runs the systems and sync points again, so only the update itself gets recorded,
+		// the entities created meanwhile are recorded by id only so that replay can map them to the entities its update creates
 		void World::update(float delta_time) {
-			for (auto& entry : priorities) {
-				auto& systems = entry.second;
-				for (System* system : systems) {
-					if (system->is_active) system->update(delta_time);
+			if (recorder) recorder->update(delta_time);
+			Suspension suspension(*this, true);
+			update_stage(System::UpdateStage::Pre_Update, delta_time);
+			if (fixed_time_step > 0) {
+				fixed_time += delta_time;
+				for (uint step = 0; step < max_fixed_steps and fixed_time >= fixed_time_step; ++step) {
+					update_stage(System::UpdateStage::Fixed_Update, fixed_time_step);
+					fixed_time -= fixed_time_step;
 				}
+				if (fixed_time >= fixed_time_step) fixed_time = std::fmod(fixed_time, fixed_time_step);
+			} else {
+				update_stage(System::UpdateStage::Fixed_Update, delta_time);
+			}
+			update_stage(System::UpdateStage::Update, delta_time);
+			update_stage(System::UpdateStage::Post_Update, delta_time);
+			for (Buffer* buffer : buffers) {
+				buffer->swap();
 			}
+			for (auto& channel : channels) {
+				if (channel) channel->swap();
+			}
+		}
+
+		// iterates by index and compiles only between stages, so systems toggled while updating don't invalidate the iteration,
+		// systems removed while updating leave an empty slot
+		void World::update_stage(System::UpdateStage stage, float delta_time) {
+			if (not schedule.compiled) compile_schedule();
+			uint index = static_cast<uint>(stage);
+			for (uint i = schedule.offsets[index]; i < schedule.offsets[index + 1]; ++i) {
+				if (schedule.systems[i]) schedule.systems[i]->update(delta_time);
+			}
+			for (uint i = 0; i < sync_points[index].size(); ++i) {
+				sync_points[index][i](*this);
+			}
+		}
+
+		void World::add_sync_point(System::UpdateStage stage, const Function<void(World&)>& callback) {
+			sync_points[static_cast<uint>(stage)].push_back(callback);
+		}
+
+		void World::set_fixed_time_step(float time_step, uint max_steps) {
+			runtime_assert(time_step >= 0, "the fixed time step of ", *this, " can't be negative");
+			runtime_assert(max_steps > 0, "the fixed update of ", *this, " needs at least one step per update");
+			fixed_time_step = time_step;
+			max_fixed_steps = max_steps;
+			fixed_time = 0;
 		}
 
+		float World::get_fixed_time_step() const {
+			return fixed_time_step;
+		}
+
+		// determines the component types once and checks them against each distinct filter
 		void World::update_systems(const Entity& entity) {
 			if (disable_system_checks) return;
-			trace("update systems with ", entity);
-			for (auto& entry : systems) {
-				System& system = *entry.second;
-				system.check(entity);
+			bool active = entity.is_active;
+			Types types;
+			if (active) types = entity.get_component_types();
+			for (auto& entry : groups) {
+				Group& group = *entry.second;
+				update_group(group, entity, active and group.filter.accepts(types));
 			}
 		}
 
-		void World::update_system(System& system) {
+		// tests the tag masks of the filters first and only collects the types for filters which also involve components
+		void World::update_tag(const Entity& entity, Tags::Mask tag) {
 			if (disable_system_checks) return;
-			trace("update system ", system);
-			for (auto& entity : entities) {
-				system.check(entity);
+			bool active = entity.is_active;
+			Tags::Mask tags = storage<Tags>().get_mask(entity.id);
+			Types types;
+			bool collected = false;
+			for (auto& entry : groups) {
+				Group& group = *entry.second;
+				const Filter& filter = group.filter;
+				if (not ((filter.get_required_tags() | filter.get_excluded_tags()) & tag)) continue;
+				bool accepted = active and filter.accepts_tags(tags);
+				if (accepted and filter.has_components()) {
+					if (not collected) types = entity.get_component_types();
+					collected = true;
+					accepted = filter.accepts(types);
+				}
+				update_group(group, entity, accepted);
+			}
+		}
+
+		void World::update_group(Group& group, const Entity& entity, bool accepted) {
+			if (accepted) {
+				if (not group.entities.insert(entity).second) return;
+				for (System* system : group.systems) {
+					ensys_trace(Add_To_System, entity.id, typeid(*system).hash_code());
+					system->on_entity_added(entity);
+				}
+			} else {
+				if (not group.entities.erase(entity)) return;
+				for (System* system : group.systems) {
+					ensys_trace(Remove_From_System, entity.id, typeid(*system).hash_code());
+					system->on_entity_removed(entity);
+				}
+			}
+		}
+
+		void World::join(System& system) {
+			Group::Key key = Group::key_of(system.filter);
+			unique<Group>& group = groups[key];
+			if (not group) {
+				trace("creating group (", system.filter, ") in ", *this);
+				group.reset(new Group(key, system.filter));
+				for (auto& entity : entities) {
+					if (is_active(entity) and group->filter.accepts(entity.get_component_types())) group->entities.insert(entity);
+				}
+			}
+			group->systems.push_back(&system);
+			system.group = group.get();
+			for (auto& entity : group->entities) {
+				ensys_trace(Add_To_System, entity.id, typeid(system).hash_code());
+				system.on_entity_added(entity);
+			}
+		}
+
+		void World::leave(System& system) {
+			Group* group = system.group;
+			auto iterator = group->entities.begin();
+			while (iterator != group->entities.end()) {
+				Entity entity = *iterator++;
+				ensys_trace(Remove_From_System, entity.id, typeid(system).hash_code());
+				system.on_entity_removed(entity);
+			}
+			group->systems.erase(find(group->systems.begin(), group->systems.end(), &system));
+			system.group = nullptr;
+			if (group->systems.empty()) {
+				trace("removing group (", group->filter, ") from ", *this);
+				groups.erase(group->key);
+			}
+		}
+
+		// claims the ids in ascending order, entities already restored by another table only get their systems updated
+		void World::restore_entities(Lot<Entity::Id> ids) {
+			trace("restoring ", ids.size(), " entities in ", *this);
+			std::sort(ids.begin(), ids.end());
+			for (uint i = 0; i < ids.size(); ++i) {
+				runtime_assert(i == 0 or ids[i - 1] != ids[i], "the persisted entity ", ids[i], " occurs twice in the mapped table of ", *this, ", can't restore it");
+				runtime_assert(not is_existing(ids[i]) or restored_entities.count(ids[i]), "the persisted entity ", ids[i], " collides with an existing entity in ", *this, ", can't restore it");
+			}
+			for (Entity::Id id : ids) {
+				Entity entity(*this, id);
+				if (restored_entities.insert(id).second) {
+					entity_ids.claim(id);
+					entities.insert(entity);
+					attributes[id].active = true;
+				}
+				update_systems(entity);
 			}
 		}
 
 		void World::clear() {
 			trace("clearing ", *this);
+			if (recorder) recorder->clear();
+			Suspension suspension(*this, false);
 			remove_all_systems();
 			remove_all_entities();
+			remove_all_resources();
 			components.clear();
 			priorities.clear();
+			storages.clear();
+			plain_tables.clear();
+			restored_entities.clear();
+			hierarchy.clear();
+			groups.clear();
+			channels.clear();
+			ordered_systems.clear();
+			schedule = Schedule();
+			for (auto& callbacks : sync_points) {
+				callbacks.clear();
+			}
+			fixed_time = 0;
+			compaction = Compaction();
+			disabled_entities.clear();
 		}
 
 		Entity World::create_entity(const String& name, const Function<void(Entity)>& function) {
-			trace("creating entity \"", name, "\" in ", *this);
 			Entity::Id id = entity_ids.acquire();
+			if (recorder) recorder->create_entity(id);
+			else if (spawn_recorder) spawn_recorder->spawn_entity(id);
 			Entity entity(*this, id);
 			entities.insert(entity);
 			auto& entity_attributes = attributes[id];
@@ -56,7 +231,7 @@ namespace tenjix {
 				function(entity);
 				disable_system_checks = false;
 			}
-			trace("created ", entity, " with ", entity.get_number_of_components(), " components");
+			ensys_trace(Create_Entity, id, entity.get_number_of_components());
 			if (entity_attributes.active) {
 				entity_attributes.active = false;
 				activate_entity(entity);
@@ -64,6 +239,14 @@ namespace tenjix {
 			return entity;
 		}
 
+		Entity World::create_entity(StagedEntity&& staged) {
+			return create_entity(staged.name, [&staged](Entity entity) {
+				for (auto& component : staged.components) {
+					entity.add(component.first, component.second);
+				}
+			});
+		}
+
 		Entities World::create_entities(const uint amount, const String& name, const Function<void(Entity)>& function) {
 			entity_ids.require(amount);
 			Entities created_entities;
@@ -74,15 +257,120 @@ namespace tenjix {
 			return created_entities;
 		}
 
+		Entity World::instantiate(const Prefab& prefab, const String& name) {
+			Entities created_entities = instantiate(prefab, 1, name);
+			return *created_entities.begin();
+		}
+
+		Entities World::instantiate(const Prefab& prefab, const uint amount, const String& name) {
+			trace("instantiating ", amount, " entities \"", name, "\" with ", prefab.get_number_of_components(), " components in ", *this);
+			entity_ids.require(amount);
+			Lot<Group*> accepting_groups;
+			for (auto& entry : groups) {
+				Group* group = entry.second.get();
+				if (group->filter.accepts(prefab.types)) accepting_groups.push_back(group);
+			}
+			Lot<Lot<shared<Component>>> blocks(prefab.prototypes.size());
+			for (uint i = 0; i < blocks.size(); ++i) {
+				prefab.prototypes[i]->instantiate(amount, blocks[i]);
+			}
+			Entities created_entities;
+			created_entities.reserve(amount);
+			entities.reserve(entities.size() + amount);
+			for (uint n = 0; n < amount; ++n) {
+				Entity::Id id = entity_ids.acquire();
+				Entity entity(*this, id);
+				entities.insert(entity);
+				auto& entity_attributes = attributes[id];
+				entity_attributes.name = name.empty() or amount == 1 ? name : name + to_string(n);
+				entity_attributes.active = true;
+				auto& entity_components = components[id];
+				entity_components.reserve(blocks.size());
+				for (uint i = 0; i < blocks.size(); ++i) {
+					entity_components.emplace(prefab.prototypes[i]->type, std::move(blocks[i][n]));
+				}
+				if (recorder) {
+					recorder->create_entity(id);
+					for (auto& prototype : prefab.prototypes) recorder->add_component(id, prototype->type);
+				} else if (spawn_recorder) {
+					spawn_recorder->spawn_entity(id);
+				}
+				if (not disable_system_checks) {
+					for (Group* group : accepting_groups) update_group(*group, entity, true);
+				}
+				created_entities.insert(entity);
+			}
+			return created_entities;
+		}
+
 		void World::destroy_entity(Entity& entity) {
 			runtime_assert(is_existing(entity), "there is no existing entity with id #", entity.id, " can't destroy");
-			trace("destroying ", entity, " in ", *this);
-			deactivate_entity(entity);
-			entity.remove_all_components();
-			entities.erase(entity);
-			entity_ids.release(entity.id);
-			attributes.erase(entity.id);
-			components.erase(entity.id);
+			destroy_batch(Lot<Entity::Id> { entity.id });
+		}
+
+		// the subtrees leave each group in one pass, while their components are still accessible to the notified systems,
+		// then each storage releases all of them, without removing their components one by one
+		void World::destroy_batch(const Lot<Entity::Id>& ids) {
+			Lot<Entity::Id> batch;
+			batch.reserve(ids.size());
+			for (Entity::Id id : ids) {
+				if (not is_existing(id)) continue;
+				Lot<Entity::Id> subtree = hierarchy.remove(id);
+				if (subtree.empty()) batch.push_back(id);
+				else batch.insert(batch.end(), subtree.begin(), subtree.end());
+			}
+			std::sort(batch.begin(), batch.end());
+			batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+			for (Entity::Id id : batch) {
+				ensys_trace(Destroy_Entity, id, 0);
+				if (recorder) recorder->destroy_entity(id);
+				else if (spawn_recorder) spawn_recorder->despawn_entity(id);
+			}
+			for (auto& entry : groups) {
+				Group& group = *entry.second;
+				for (Entity::Id id : batch) {
+					update_group(group, Entity(*this, id), false);
+				}
+			}
+			for (auto& entry : storages) {
+				for (Entity::Id id : batch) {
+					entry.second->release(id);
+				}
+			}
+			for (Entity::Id id : batch) {
+				erase_entity(id);
+			}
+		}
+
+		void World::claim_plain_type(Type component_type, Type table_type) {
+			auto result = plain_tables.emplace(component_type, table_type);
+			runtime_assert(result.second or result.first->second == table_type, "plain component type ", component_type, " is already stored in ", result.first->second, " of ", *this, ", can't store it in another table");
+		}
+
+		ColdComponents* World::find_cold_components() const {
+			auto iterator = storages.find(typeid(ColdComponents));
+			return iterator == storages.end() ? nullptr : static_cast<ColdComponents*>(iterator->second.get());
+		}
+
+		void World::thaw(Entity::Id id) {
+			ColdComponents* cold = find_cold_components();
+			if (not cold or not cold->contains(id)) return;
+			trace("moving the components of entity #", id, " out of cold storage");
+			cold->thaw_entity(id, components[id], storages);
+		}
+
+		void World::erase_entity(Entity::Id id) {
+			entities.erase(Entity(*this, id));
+			release_id(id);
+			if (id < disabled_entities.size()) disabled_entities[id] = 0;
+			attributes.erase(id);
+			components.erase(id);
+			restored_entities.erase(id);
+			auto original = compaction.originals.find(id);
+			if (original != compaction.originals.end()) {
+				compaction.translations[original->second] = IDs::No_Id;
+				compaction.originals.erase(original);
+			}
 		}
 
 		void World::destroy_entity(const Entity::Id & id) {
@@ -90,10 +378,215 @@ namespace tenjix {
 			destroy_entity(entity);
 		}
 
+		// destroys a snapshot of the ids, the given entities may be (a view of) the entities of this world
 		void World::destroy_entities(const Entities& entities) {
-			for (auto entity : entities) {
-				if (is_existing(entity)) destroy_entity(entity);
+			Lot<Entity::Id> ids;
+			ids.reserve(entities.size());
+			for (auto& entity : entities) {
+				ids.push_back(entity.id);
+			}
+			destroy_batch(ids);
+		}
+
+		// the accepting groups are determined once per distinct component signature of the staged entities
+		Entities World::commit(StagedCell& cell) {
+			trace("committing ", cell.entities.size(), " entities of cell #", cell.cell, " to ", *this);
+			Cells& cells = get_cells();
+			entity_ids.require(cell.entities.size());
+			entities.reserve(entities.size() + cell.entities.size());
+			std::map<Lot<Type>, Lot<Group*>> accepting_groups;
+			Entities committed_entities;
+			committed_entities.reserve(cell.entities.size());
+			for (StagedEntity& staged : cell.entities) {
+				Entity::Id id = entity_ids.acquire();
+				Entity entity(*this, id);
+				entities.insert(entity);
+				auto& entity_attributes = attributes[id];
+				entity_attributes.name = std::move(staged.name);
+				entity_attributes.active = true;
+				auto& entity_components = components[id];
+				entity_components.reserve(staged.components.size());
+				for (auto& component : staged.components) {
+					entity_components.emplace(component.first, std::move(component.second));
+				}
+				cells.assign(id, cell.cell);
+				ensys_trace(Create_Entity, id, staged.components.size());
+				if (recorder) {
+					recorder->create_entity(id);
+					for (Type type : staged.types) recorder->add_component(id, type);
+				} else if (spawn_recorder) {
+					spawn_recorder->spawn_entity(id);
+				}
+				if (not disable_system_checks) {
+					Lot<Type> signature(staged.types.begin(), staged.types.end());
+					std::sort(signature.begin(), signature.end());
+					auto iterator = accepting_groups.find(signature);
+					if (iterator == accepting_groups.end()) {
+						Lot<Group*> accepting;
+						for (auto& entry : groups) {
+							if (entry.second->filter.accepts(staged.types)) accepting.push_back(entry.second.get());
+						}
+						iterator = accepting_groups.emplace(std::move(signature), std::move(accepting)).first;
+					}
+					for (Group* group : iterator->second) update_group(*group, entity, true);
+				}
+				committed_entities.insert(entity);
 			}
+			cell.entities.clear();
+			return committed_entities;
+		}
+
+		uint World::commit(Staging& staging) {
+			uint number_of_entities = 0;
+			for (StagedCell& cell : staging.take()) {
+				number_of_entities += commit(cell).size();
+			}
+			return number_of_entities;
+		}
+
+		// destroys the entities of the cell and their descendants in one batch
+		void World::evict_cell(Cells::Id cell) {
+			Cells& cells = get_cells();
+			if (not cells.has_cell(cell)) return;
+			Lot<Entity::Id> ids(cells.get_entities(cell).begin(), cells.get_entities(cell).end());
+			trace("evicting ", ids.size(), " entities of cell #", cell, " from ", *this);
+			destroy_batch(ids);
+		}
+
+		Cells& World::get_cells() {
+			return storage<Cells>();
+		}
+
+		// moves the planned entities into place one target id after another,
+		// an unplaced entity occupying the target id is moved out of the way to a fresh id above all others
+		bool World::compact(uint budget) {
+			if (not compaction.running) plan_compaction();
+			uint moves = 0;
+			while (compaction.next < compaction.plan.size() and moves < budget) {
+				Entity::Id target = compaction.next + 1;
+				Entity::Id current = compaction.translations.at(compaction.plan[compaction.next++]);
+				if (current == target or current == IDs::No_Id) continue;
+				if (is_existing(target)) {
+					Entity::Id original = compaction.originals.at(target);
+					Entity::Id temporary = entity_ids.acquire();
+					entity_ids.release(temporary);
+					renumber(target, temporary);
+					compaction.translations[original] = temporary;
+					compaction.originals.erase(target);
+					compaction.originals[temporary] = original;
+					moves++;
+				}
+				renumber(current, target);
+				Entity::Id original = compaction.originals.at(current);
+				compaction.translations[original] = target;
+				compaction.originals.erase(current);
+				compaction.originals[target] = original;
+				moves++;
+			}
+			if (compaction.next < compaction.plan.size()) return false;
+			trace("compacted ", compaction.plan.size(), " entities in ", *this);
+			entity_ids.rebuild();
+			shrink();
+			compaction.running = false;
+			compaction.plan = Lot<Entity::Id>();
+			return true;
+		}
+
+		Entity::Id World::translate(Entity::Id id) const {
+			auto iterator = compaction.translations.find(id);
+			return iterator == compaction.translations.end() ? id : iterator->second;
+		}
+
+		bool World::is_compacting() const {
+			return compaction.running;
+		}
+
+		// groups the entities by their sorted component types, ids released meanwhile are withheld from reuse,
+		// so entities created during the compaction get ids above the compacted range
+		void World::plan_compaction() {
+			trace("planning the compaction of ", entities.size(), " entities in ", *this);
+			std::map<Lot<Type>, Lot<Entity::Id>> signatures;
+			for (auto& entity : entities) {
+				Types types = entity.get_component_types();
+				Lot<Type> signature(types.begin(), types.end());
+				std::sort(signature.begin(), signature.end());
+				signatures[signature].push_back(entity.id);
+			}
+			compaction = Compaction();
+			compaction.plan.reserve(entities.size());
+			for (auto& entry : signatures) {
+				Lot<Entity::Id> ids = std::move(entry.second);
+				std::sort(ids.begin(), ids.end());
+				compaction.plan.insert(compaction.plan.end(), ids.begin(), ids.end());
+			}
+			compaction.translations.reserve(compaction.plan.size());
+			compaction.originals.reserve(compaction.plan.size());
+			for (Entity::Id id : compaction.plan) {
+				compaction.translations.emplace(id, id);
+				compaction.originals.emplace(id, id);
+			}
+			compaction.running = true;
+			entity_ids.withhold();
+		}
+
+		void World::renumber(Entity::Id from, Entity::Id to) {
+			Entity old_entity(*this, from);
+			Entity new_entity(*this, to);
+			Lot<Group*> joined_groups;
+			for (auto& entry : groups) {
+				Group& group = *entry.second;
+				if (not group.entities.count(old_entity)) continue;
+				update_group(group, old_entity, false);
+				joined_groups.push_back(&group);
+			}
+			entity_ids.claim(to);
+			entities.erase(old_entity);
+			entities.insert(new_entity);
+			auto entity_attributes = attributes.find(from);
+			Attributes moved_attributes = std::move(entity_attributes->second);
+			attributes.erase(entity_attributes);
+			attributes.emplace(to, std::move(moved_attributes));
+			auto entity_components = components.find(from);
+			if (entity_components != components.end()) {
+				MappedComponents::mapped_type moved_components = std::move(entity_components->second);
+				components.erase(entity_components);
+				components.emplace(to, std::move(moved_components));
+			}
+			if (from < disabled_entities.size() and disabled_entities[from]) {
+				disabled_entities[from] = 0;
+				if (to >= disabled_entities.size()) disabled_entities.resize(to + 1, 0);
+				disabled_entities[to] = 1;
+			}
+			for (auto& entry : storages) {
+				entry.second->renumber(from, to);
+			}
+			hierarchy.renumber(from, to);
+			release_id(from);
+			if (recorder) recorder->renumber_entity(from, to);
+			for (Group* group : joined_groups) {
+				update_group(*group, new_entity, true);
+			}
+		}
+
+		void World::shrink() {
+			attributes.rehash(0);
+			components.rehash(0);
+			entities.rehash(0);
+			for (auto& entry : groups) {
+				entry.second->entities.rehash(0);
+			}
+			for (auto& entry : storages) {
+				entry.second->shrink();
+			}
+			hierarchy.shrink();
+			uint last = disabled_entities.size();
+			while (last > 0 and not disabled_entities[last - 1]) --last;
+			disabled_entities.resize(last);
+			disabled_entities.shrink_to_fit();
+		}
+
+		void World::record(Recorder* recorder) {
+			this->recorder = recorder;
 		}
 
 		Entity World::get_entity(const Entity::Id id) const {
@@ -157,7 +650,9 @@ namespace tenjix {
 			runtime_assert(is_existing(entity), "there is no existing entity with id #", entity.id, " can't activate");
 			bool& active = attributes[entity.id].active;
 			if (not active) {
+				thaw(entity.id);
 				trace("activating ", entity, " in ", *this);
+				if (recorder) recorder->activate_entity(entity.id);
 				active = true;
 				update_systems(entity);
 			}
@@ -168,19 +663,63 @@ namespace tenjix {
 			activate_entity(entity);
 		}
 
-		void World::deactivate_entity(Entity& entity) {
+		// cold entities leave their groups before their components move, so systems can still access them when notified
+		void World::deactivate_entity(Entity& entity, bool cold) {
 			runtime_assert(is_existing(entity), "there is no existing entity with id #", entity.id, " can't deactivate");
 			bool& active = attributes[entity.id].active;
+			if (recorder and (active or cold)) recorder->deactivate_entity(entity.id, cold);
 			if (active) {
 				trace("deactivating ", entity, " in ", *this);
 				active = false;
 				update_systems(entity);
 			}
+			if (not cold) return;
+			ColdComponents& cold_components = storage<ColdComponents>();
+			if (cold_components.contains(entity.id)) return;
+			Entity::ComponentMap frozen;
+			auto entity_components = components.find(entity.id);
+			if (entity_components != components.end()) {
+				frozen = std::move(entity_components->second);
+				components.erase(entity_components);
+			}
+			trace("moving ", frozen.size(), " components of ", entity, " into cold storage");
+			cold_components.freeze_entity(entity.id, std::move(frozen), storages);
 		}
 
-		void World::deactivate_entity(const Entity::Id & id) {
+		void World::deactivate_entity(const Entity::Id & id, bool cold) {
 			Entity entity = get_entity(id);
-			deactivate_entity(entity);
+			deactivate_entity(entity, cold);
+		}
+
+		void World::enable_entity(Entity& entity) {
+			enable_entity(entity.id);
+		}
+
+		void World::enable_entity(const Entity::Id& id) {
+			runtime_assert(is_existing(id), "there is no existing entity with id #", id, " can't enable");
+			if (id < disabled_entities.size()) disabled_entities[id] = 0;
+		}
+
+		void World::disable_entity(Entity& entity) {
+			disable_entity(entity.id);
+		}
+
+		void World::disable_entity(const Entity::Id& id) {
+			runtime_assert(is_existing(id), "there is no existing entity with id #", id, " can't disable");
+			if (id >= disabled_entities.size()) disabled_entities.resize(id + 1, 0);
+			disabled_entities[id] = 1;
+		}
+
+		bool World::is_enabled(const Entity& entity) const {
+			return is_enabled(entity.id);
+		}
+
+		bool World::is_enabled(const Entity::Id id) const {
+			return is_existing(id) and not (id < disabled_entities.size() and disabled_entities[id]);
+		}
+
+		Span<const unsigned char> World::get_disabled_flags() const {
+			return Span<const unsigned char>(disabled_entities.data(), disabled_entities.size());
 		}
 
 		bool World::is_active(const Entity& entity) const {
@@ -199,37 +738,42 @@ namespace tenjix {
 			return entity_ids.exists(id);
 		}
 
+		uint World::get_generation(Entity::Id id) const {
+			return id < generations.size() ? generations[id] : 0;
+		}
+
+		void World::release_id(Entity::Id id) {
+			entity_ids.release(id);
+			if (id >= generations.size()) generations.resize(id + 1, 0);
+			generations[id]++;
+		}
+
 		uint World::get_number_of_entities() const {
 			return entities.size();
 		}
 
-		const Entities World::get_entities() const {
+		const Entities& World::get_entities() const {
 			return entities;
 		}
 
+		// destroying an entity destroys its descendants too, so the ids are copied first and destroyed descendants skipped
 		void World::remove_all_entities() {
 			trace("removing all entities from ", *this);
-			auto iterator = entities.begin();
-			uint n = 0;
-			while (iterator != entities.end()) {
-				auto entity = *iterator++;
-				destroy_entity(entity);
-				n++;
+			Lot<Entity::Id> ids;
+			ids.reserve(entities.size());
+			for (auto& entity : entities) {
+				ids.push_back(entity.id);
 			}
-			trace("removed ", n, " entities from ", *this);
+			destroy_batch(ids);
+			trace("removed ", ids.size(), " entities from ", *this);
 		}
 
 		uint World::get_number_of_systems() const {
 			return systems.size();
 		}
 
-		const Systems World::get_systems() const {
-			Systems list(get_number_of_systems());
-			for (auto& entry : systems) {
-				System* system = entry.second.get();
-				list.push_back(system);
-			}
-			return list;
+		const Systems& World::get_systems() const {
+			return ordered_systems;
 		}
 
 		void World::remove_all_systems() {
@@ -244,6 +788,27 @@ namespace tenjix {
 			trace("removed ", n, " systems from ", *this);
 		}
 
+		uint World::get_number_of_resources() const {
+			return std::count_if(resources.begin(), resources.end(), [](const unique<Resource>& resource) { return resource != nullptr; });
+		}
+
+		const Types World::get_resource_types() const {
+			Types types;
+			for (auto& resource : resources) {
+				if (resource) types.insert(resource->type);
+			}
+			return types;
+		}
+
+		void World::remove_all_resources() {
+			trace("removing all resources from ", *this);
+			resources.clear();
+		}
+
+		const Hierarchy& World::get_hierarchy() const {
+			return hierarchy;
+		}
+
 		std::ostream& operator<<(std::ostream& output, const World& world) {
 			output << "\"" << world.name << "\"";
 			return output;
@@ -253,27 +818,60 @@ namespace tenjix {
 
 		void World::add(Type system_type, System*const system) {
 			trace("adding ", system_type, " (", system->filter, ") to ", *this);
+			if (recorder) recorder->add_system(system_type);
 			system->world.pointer = this;
 			priorities[system->priority].push_back(system);
 			systems.emplace(system_type, system);
+			order_systems();
 			system->initialize();
-			update_system(*system);
+			if (Buffer* buffer = dynamic_cast<Buffer*>(system)) buffers.push_back(buffer);
+			join(*system);
 			trace("added ", system->get_number_of_entities(), " entities to ", system_type);
 			system->activate();
 		}
 
 		void World::remove(Type system_type) {
 			trace("removing ", system_type, " from ", *this);
+			if (recorder) recorder->remove_system(system_type);
 			auto iterator = systems.find(system_type);
 			unique<System>& system = iterator->second;
 			system->deactivate();
 			auto number_of_entities = system->get_number_of_entities();
-			system->remove_all_entities();
+			leave(*system);
 			trace("removed ", number_of_entities, " entities from ", system_type);
 			system->terminate();
+			if (Buffer* buffer = dynamic_cast<Buffer*>(system.get())) buffers.erase(find(buffers.begin(), buffers.end(), buffer));
 			Systems& list = priorities[system->priority];
 			list.erase(find(list.begin(), list.end(), system.get()));
+			// a stage may be iterating the schedule, so the slot is cleared instead of erased until the schedule gets recompiled
+			std::replace(schedule.systems.begin(), schedule.systems.end(), system.get(), static_cast<System*>(nullptr));
 			systems.erase(iterator);
+			order_systems();
+		}
+
+		void World::order_systems() {
+			ordered_systems.clear();
+			for (uint stage = 0; stage < System::Number_Of_Stages; ++stage) {
+				for (auto& entry : priorities) {
+					for (System* system : entry.second) {
+						if (static_cast<uint>(system->stage) == stage) ordered_systems.push_back(system);
+					}
+				}
+			}
+			schedule.compiled = false;
+		}
+
+		// the offset of a stage is the number of active systems of the stages before it
+		void World::compile_schedule() {
+			schedule.systems.clear();
+			uint stage = 0;
+			for (System* system : ordered_systems) {
+				if (not system->is_active) continue;
+				while (stage <= static_cast<uint>(system->stage)) schedule.offsets[stage++] = schedule.systems.size();
+				schedule.systems.push_back(system);
+			}
+			while (stage <= System::Number_Of_Stages) schedule.offsets[stage++] = schedule.systems.size();
+			schedule.compiled = true;
 		}
 
 		bool World::has(Type system_type) const {
@@ -1,10 +1,28 @@
 #pragma once
 
+#include <limits>
+
+#include <ensys/Cold.h>
 #include <ensys/Entity.h>
+#include <ensys/Events.h>
+#include <ensys/Group.h>
+#include <ensys/Hierarchy.h>
 #include <ensys/Component.h>
+#include <ensys/Recorder.h>
+#include <ensys/Span.h>
 #include <ensys/System.h>
 #include <ensys/Attributes.h>
+#include <ensys/Buffered.h>
 #include <ensys/IDs.h>
+#include <ensys/Partition.h>
+#include <ensys/Prefab.h>
+#include <ensys/Resource.h>
+#include <ensys/Shared.h>
+#include <ensys/Storage.h>
+#include <ensys/Table.h>
+#include <ensys/Tags.h>
+#include <ensys/Trace.h>
+#include <ensys/TypeIndex.h>
 
 #include <utilities/Assertions.h>
 #include <utilities/Types.h>
@@ -16,6 +34,7 @@ namespace tenjix {
 		class World final {
 
 			friend Entity;
+			friend System;
 
 			using MappedAttributes = Map<Entity::Id, Attributes>;
 			using MappedComponents = Map<Entity::Id, Map<Type, shared<Component>>>;
@@ -27,6 +46,57 @@ namespace tenjix {
 			MappedPriorities priorities;
 			MappedSystems systems;
 
+			// the systems in update order (by stage, then descending priority, then insertion order)
+			Systems ordered_systems;
+
+			// the active systems flattened in update order, compiled when systems get added, removed or toggled
+			struct Schedule {
+				Systems systems;
+				// the index of the first system of each stage, followed by the number of systems
+				uint offsets[System::Number_Of_Stages + 1] = {};
+				bool compiled = false;
+			};
+
+			Schedule schedule;
+
+			// the callbacks invoked at the sync point after each stage, indexed by stage
+			Lot<Function<void(World&)>> sync_points[System::Number_Of_Stages];
+
+			// the time step of the fixed update stage (zero runs the stage once per update with its delta time)
+			float fixed_time_step = 0;
+			// the time not yet consumed by fixed update steps
+			float fixed_time = 0;
+			// the maximum number of fixed update steps per update
+			uint max_fixed_steps = 8;
+
+			// the entity groups by canonical filter, shared by systems with equal filters
+			Groups groups;
+
+			Storages storages;
+
+			// the type of the table storing each plain component type (a plain type lives in one table only)
+			Map<Type, Type> plain_tables;
+
+			// the entities restored from the rows of mapped tables, an entity may have rows in several of them
+			Set<Entity::Id> restored_entities;
+
+			// resources indexed by their type index
+			Resources resources;
+
+			Hierarchy hierarchy;
+
+			// the disabled flag of each entity by id (disabled entities keep their system membership)
+			Lot<unsigned char> disabled_entities;
+
+			// the number of times each id was released, so ids kept across the reuse of an id can be told apart
+			Lot<uint> generations;
+
+			// the component buffers swapped at the end of each update
+			Lot<Buffer*> buffers;
+
+			// the event channels indexed by event type, swapped at the end of each update
+			Lot<unique<Channel>> channels;
+
 			Entities entities;
 
 			IDs entity_ids;
@@ -35,6 +105,29 @@ namespace tenjix {
 
 			bool disable_system_checks = false;
 
+			// the recorder of the operations on this world (nullptr while not recording or while recording is suspended)
+			Recorder* recorder = nullptr;
+			// the recorder while updating, which only gets the entities created and destroyed by the update
+			Recorder* spawn_recorder = nullptr;
+
+			// suspends recording for its lifetime, restoring the recorder even when an exception leaves the scope
+			struct Suspension;
+
+			// the state of an incremental compaction
+			struct Compaction {
+				// the ids the entities had at the start, in their target order (the target id of plan[i] is i + 1)
+				Lot<Entity::Id> plan;
+				// the current id of each entity by its id at the start (No_Id for destroyed entities)
+				Map<Entity::Id, Entity::Id> translations;
+				// the id at the start of each existing entity by its current id
+				Map<Entity::Id, Entity::Id> originals;
+				// the index of the next entity to move into place
+				uint next = 0;
+				bool running = false;
+			};
+
+			Compaction compaction;
+
 		public:
 
 			explicit World(String name = "World", uint initial_entity_pool_size = 1000);
@@ -45,14 +138,28 @@ namespace tenjix {
 			World& operator=(const World&) = delete;
 			World& operator=(World&&) = delete;
 
-			// updates the world
+			// updates the systems stage by stage, then publishes buffered components and the events emitted during the update
+			// (systems toggled, added or removed during an update take effect from the next stage on)
 			void update(float delta_time);
 
-			// clears the world by removing all systems and entities
+			// invokes the given callback at the sync point after the given stage of each update (e.g. to flush command buffers)
+			void add_sync_point(System::UpdateStage stage, const Function<void(World&)>& callback);
+
+			// updates the fixed update stage in steps of the given time, as often as the accumulated delta times allow
+			// (zero updates the stage once per update with its delta time)
+			// at most the given number of steps run per update, the time beyond is dropped,
+			// so a slow update doesn't make the following updates even slower
+			void set_fixed_time_step(float time_step, uint max_steps = 8);
+
+			float get_fixed_time_step() const;
+
+			// clears the world by removing all systems, entities and resources
 			void clear();
 
 			// creates and activates a new entity (accepts a function to execute before the entity gets activated)
 			Entity create_entity(const String& name = "", const Function<void(Entity)>& function = nullptr);
+			// creates and activates a new entity with the components of the given staged entity
+			Entity create_entity(StagedEntity&& staged);
 			// creates and activates multiple new entities (accepts a function to execute on each entity before it gets activated)
 			Entities create_entities(const uint amount, const String& name = "", const Function<void(Entity)>& function = nullptr);
 			// creates and activates a new entity with the given components (accepts a function to execute before the entity gets activated)
@@ -61,18 +168,49 @@ namespace tenjix {
 			// creates and activates multiple new entities with given components (accepts a function to execute on each entity before it gets activated)
 			template <class... Components>
 			Entities create_entities_with(const uint number_of_entities, const String& name = "", const Function<void(Entity)>& function = nullptr);
+			// creates and activates a new entity from the given prefab
+			Entity instantiate(const Prefab& prefab, const String& name = "");
+			// creates and activates multiple new entities from the given prefab, copying the prefabs components in bulk
+			Entities instantiate(const Prefab& prefab, const uint amount, const String& name = "");
 			//template <class... Components>
 			//Entity create_entity_with_shared(const String& name = "", const Function<void(Entity)>& function = nullptr);
 			//template <class... Components>
 			//Entities create_entities_with_shared(const uint number_of_entities, const String& name = "", const Function<void(Entity)>& function = nullptr);
 
-			// destroys an entity with its components
+			// destroys an entity with its components and descendants
 			void destroy_entity(Entity& entity);
-			// destroys an entity with its components
+			// destroys an entity with its components and descendants
 			void destroy_entity(const Entity::Id& id);
 			// destroys multiple entities at once
 			void destroy_entities(const Entities& entities);
 
+			// splices the entities of a staged cell into this world, resolving system membership once per distinct component signature
+			Entities commit(StagedCell& cell);
+			// commits all cells staged so far, returns the number of committed entities
+			uint commit(Staging& staging);
+
+			// destroys all entities tagged with the given cell (and their descendants) in one batch
+			void evict_cell(Cells::Id cell);
+
+			// returns the cells the entities of this world are tagged with
+			Cells& get_cells();
+
+			// renumbers the entities into a dense range of ids ordered by component signature, moving at most budget entities per call,
+			// then shrinks the containers to their size, returns whether the compaction is complete
+			// (continue it across updates, systems see renumbered entities as removed and added again)
+			bool compact(uint budget = std::numeric_limits<uint>::max());
+
+			// returns the current id of an entity known by its id from before the running or the last compaction
+			// (No_Id if the entity was destroyed since)
+			Entity::Id translate(Entity::Id id) const;
+
+			// checks whether a compaction is running
+			bool is_compacting() const;
+
+			// records the operations on this world into the given recorder until recording gets stopped by passing nullptr
+			// (while not recording, recording costs a single check per operation)
+			void record(Recorder* recorder);
+
 			// returns the entity with the given id
 			Entity get_entity(const Entity::Id id) const;
 
@@ -100,9 +238,30 @@ namespace tenjix {
 			void activate_entity(const Entity::Id& id);
 
 			// deactivates an entity, excluding it from system updates
-			void deactivate_entity(Entity& entity);
+			// (cold entities move their components into the cold store, leaving the component map to active entities, until they get activated)
+			void deactivate_entity(Entity& entity, bool cold = false);
 			// deactivates an entity, excluding it from system updates
-			void deactivate_entity(const Entity::Id& id);
+			// (cold entities move their components into the cold store, leaving the component map to active entities, until they get activated)
+			void deactivate_entity(const Entity::Id& id, bool cold = false);
+
+			// enables an entity, including it in system iterations again (constant time)
+			void enable_entity(Entity& entity);
+			// enables an entity, including it in system iterations again (constant time)
+			void enable_entity(const Entity::Id& id);
+
+			// disables an entity, skipping it in system iterations without changing system membership (constant time)
+			void disable_entity(Entity& entity);
+			// disables an entity, skipping it in system iterations without changing system membership (constant time)
+			void disable_entity(const Entity::Id& id);
+
+			// checks whether a given entity is existing and enabled
+			bool is_enabled(const Entity& entity) const;
+			// checks whether a given entity is existing and enabled
+			bool is_enabled(const Entity::Id id) const;
+
+			// returns the disabled flag of each entity by id, ids beyond the end are enabled
+			// (for inline checks of entities known to exist in hot loops, valid until entities get disabled)
+			Span<const unsigned char> get_disabled_flags() const;
 
 			// checks whether a given entity is existing and active
 			bool is_active(const Entity& entity) const;
@@ -114,11 +273,15 @@ namespace tenjix {
 			// checks whether a entity with the given id is existing
 			bool is_existing(const Entity::Id id) const;
 
+			// returns the generation of an id, which changes whenever the id gets released (also by clear and compaction),
+			// so an id together with its generation identifies an entity even after the id got reused
+			uint get_generation(Entity::Id id) const;
+
 			// returns the number of entities (including deactivated ones)
 			uint get_number_of_entities() const;
 
 			// returns all entities of this world
-			const Entities get_entities() const;
+			const Entities& get_entities() const;
 
 			// removes all entities from this world
 			void remove_all_entities();
@@ -144,22 +307,118 @@ namespace tenjix {
 			// returns the number of systems within the world
 			uint get_number_of_systems() const;
 
-			// returns all systems of this world
-			const Systems get_systems() const;
+			// returns all systems of this world in update order
+			const Systems& get_systems() const;
 
 			// removes all systems from this world
 			void remove_all_systems();
 
+			template <class ResourceType, typename... Arguments>
+			ResourceType& add_resource(Arguments&&... arguments);
+
+			template <class ResourceType>
+			void remove_resource();
+
+			template <class ResourceType>
+			bool has_resource() const;
+
+			template <class ResourceType>
+			ResourceType& resource() const;
+
+			// returns the number of resources within the world
+			uint get_number_of_resources() const;
+
+			// returns the types of all resources of this world
+			const Types get_resource_types() const;
+
+			// removes all resources from this world
+			void remove_all_resources();
+
+			// returns the parent child relations between the entities of this world
+			const Hierarchy& get_hierarchy() const;
+
+			// returns the storage of the given type owned by this world, constructs it if necessary
+			template <class StorageType>
+			StorageType& storage();
+
+			// returns the channel of events of the given type, constructs it if necessary
+			// (construct channels before emitting from parallel systems, e.g. when a system gets added)
+			template <class EventType>
+			Events<EventType>& events();
+
+			// returns the store of values of the given type shared by entities of this world
+			template <class ValueType, class Hash = std::hash<ValueType>>
+			SharedValues<ValueType, Hash>& shared_values();
+
+			// returns the table storing plain components of the given types together
+			template <class... ComponentTypes>
+			Table<ComponentTypes...>& table();
+
+			// places the table of the given types in chunks of the given allocator (e.g. a memory mapped file),
+			// the rows persisted by the allocator are restored as entities with their former ids,
+			// so persisted tables should be mapped before creating entities
+			template <class... ComponentTypes>
+			Table<ComponentTypes...>& map_table(ChunkAllocator& allocator);
+
 			friend std::ostream& operator<<(std::ostream& output, const World& world);
 
 		private:
 
 			void update_systems(const Entity& entity);
-			void update_system(System& system);
+			void update_group(Group& group, const Entity& entity, bool accepted);
+
+			// updates the groups after the given tag of the entity changed, only groups whose filters involve the tag can change
+			void update_tag(const Entity& entity, Tags::Mask tag);
+
+			// adds the system to the group of its filter, creating and populating the group if necessary
+			void join(System& system);
+			// removes the system from its group, removing the group if no system is left
+			void leave(System& system);
+
+			// plans a compaction, ordering the entities by component signature and then by id
+			void plan_compaction();
+
+			// moves the entity with the given id to the given unused id, notifying its systems
+			void renumber(Entity::Id from, Entity::Id to);
+
+			// shrinks the containers of this world to their size
+			void shrink();
+
+			// returns the cold store (or nullptr if no entity was ever deactivated cold)
+			ColdComponents* find_cold_components() const;
+
+			// moves the components of a cold entity back into the component map
+			void thaw(Entity::Id id);
+
+			// records the table storing a plain component type, asserting no other table stores it
+			void claim_plain_type(Type component_type, Type table_type);
+
+			// destroys the entities with the given ids (skipping non existing ones) and their descendants at once
+			void destroy_batch(const Lot<Entity::Id>& ids);
+
+			// erases the entity and releases its id, after it left all groups and storages
+			void erase_entity(Entity::Id id);
+
+			// releases the id and advances its generation
+			void release_id(Entity::Id id);
+
+			// recreates the entities with the given ids, which were persisted with the rows of a mapped table
+			// entities already restored from another mapped table only get their systems updated,
+			// asserts that none of the other ids is in use already and that no id occurs twice
+			void restore_entities(Lot<Entity::Id> ids);
 
 			Entity find_entity(const Function<bool(const Attributes&)>& accepts) const;
 			Entities find_entities(const Function<bool(const Attributes&)>& accepts) const;
 
+			// flattens the systems by stage and priority into the update order
+			void order_systems();
+
+			// collects the active systems in update order into the schedule
+			void compile_schedule();
+
+			// updates the systems of the given stage, then invokes the callbacks of its sync point
+			void update_stage(System::UpdateStage stage, float delta_time);
+
 			/// template implementation details
 			void add(Type system_type, System*const system);
 			void remove(Type system_type);
@@ -241,6 +500,181 @@ namespace tenjix {
 			get(type).deactivate();
 		}
 
+		// adds a resource of the given type to this world, constructed with the given arguments
+		template <class ResourceType, typename... Arguments>
+		ResourceType& World::add_resource(Arguments&&... arguments) {
+			uint index = TypeIndex<Resource>::of<ResourceType>();
+			if (index >= resources.size()) resources.resize(index + 1);
+			unique<Resource>& resource = resources[index];
+			runtime_assert(not resource, "a resource of type ", Type(typeid(ResourceType)), " already exists in ", *this, ", can't add another");
+			trace("adding resource ", Type(typeid(ResourceType)), " to ", *this);
+			auto slot = new ResourceSlot<ResourceType>(std::forward<Arguments>(arguments)...);
+			resource.reset(slot);
+			return slot->value;
+		}
+
+		// removes the resource of the given type from this world
+		template <class ResourceType>
+		void World::remove_resource() {
+			runtime_assert(has_resource<ResourceType>(), "a resource of type ", Type(typeid(ResourceType)), " doesn't exist in ", *this, ", can't remove it");
+			trace("removing resource ", Type(typeid(ResourceType)), " from ", *this);
+			resources[TypeIndex<Resource>::of<ResourceType>()].reset();
+		}
+
+		// checks whether this world has a resource of the given type
+		template <class ResourceType>
+		bool World::has_resource() const {
+			uint index = TypeIndex<Resource>::of<ResourceType>();
+			return index < resources.size() and resources[index];
+		}
+
+		// returns the resource of the given type owned by this world (constant time, no lookup)
+		template <class ResourceType>
+		ResourceType& World::resource() const {
+			runtime_assert(has_resource<ResourceType>(), "a resource of type ", Type(typeid(ResourceType)), " doesn't exist in ", *this, ", can't retrieve it");
+			return static_cast<ResourceSlot<ResourceType>&>(*resources[TypeIndex<Resource>::of<ResourceType>()]).value;
+		}
+
+		// returns the storage of the given type owned by this world, constructs it if necessary
+		template <class StorageType>
+		StorageType& World::storage() {
+			static_assert(std::is_base_of<Storage, StorageType>(), "given type is not a storage, can't retrieve it from world");
+			unique<Storage>& storage = storages[typeid(StorageType)];
+			if (not storage) storage.reset(new StorageType());
+			return static_cast<StorageType&>(*storage);
+		}
+
+		// returns the channel of events of the given type, constructs it if necessary
+		template <class EventType>
+		Events<EventType>& World::events() {
+			uint index = TypeIndex<Channel>::of<EventType>();
+			if (index >= channels.size()) channels.resize(index + 1);
+			unique<Channel>& channel = channels[index];
+			if (not channel) channel.reset(new Events<EventType>());
+			return static_cast<Events<EventType>&>(*channel);
+		}
+
+		// returns the store of values of the given type shared by entities of this world
+		template <class ValueType, class Hash>
+		SharedValues<ValueType, Hash>& World::shared_values() {
+			return storage<SharedValues<ValueType, Hash>>();
+		}
+
+		// returns the table storing plain components of the given types together
+		template <class... ComponentTypes>
+		Table<ComponentTypes...>& World::table() {
+			unique<Storage>& storage = storages[typeid(Table<ComponentTypes...>)];
+			if (not storage) {
+				for_each_variadic(claim_plain_type(typeid(ComponentTypes), typeid(Table<ComponentTypes...>)));
+				storage.reset(new Table<ComponentTypes...>());
+			}
+			return static_cast<Table<ComponentTypes...>&>(*storage);
+		}
+
+		template <class... ComponentTypes>
+		Table<ComponentTypes...>& World::map_table(ChunkAllocator& allocator) {
+			unique<Storage>& storage = storages[typeid(Table<ComponentTypes...>)];
+			runtime_assert(not storage, "the table of the given component types already exists in ", *this, ", can't map it");
+			for_each_variadic(claim_plain_type(typeid(ComponentTypes), typeid(Table<ComponentTypes...>)));
+			auto table = new Table<ComponentTypes...>(allocator);
+			storage.reset(table);
+			Lot<Entity::Id> ids;
+			ids.reserve(table->get_number_of_rows());
+			for (uint chunk = 0; chunk < table->get_number_of_chunks(); ++chunk) {
+				auto chunk_ids = table->get_ids(chunk);
+				ids.insert(ids.end(), chunk_ids.begin(), chunk_ids.end());
+			}
+			restore_entities(ids);
+			return *table;
+		}
+
+		// shares the given value with this entity, equal values are stored only once per world
+		template <class ValueType>
+		const ValueType& Entity::add_shared_value(const ValueType& value) {
+			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't add shared values");
+			auto& values = world.shared_values<ValueType>();
+			runtime_assert(not values.contains(id), *this, " already shares a value of type ", Type(typeid(ValueType)), ", can't add another");
+			ensys_trace(Add_Component, id, typeid(ValueType).hash_code());
+			auto index = values.acquire(id, value);
+			world.update_systems(*this);
+			return values.get_value(index);
+		}
+
+		// stops sharing the value of the given type with this entity
+		template <class ValueType>
+		void Entity::remove_shared_value() {
+			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't remove shared values");
+			auto& values = world.shared_values<ValueType>();
+			runtime_assert(values.contains(id), *this, " doesn't share a value of type ", Type(typeid(ValueType)), ", can't remove it");
+			ensys_trace(Remove_Component, id, typeid(ValueType).hash_code());
+			values.release(id);
+			world.update_systems(*this);
+		}
+
+		// checks whether this entity shares a value of the given type
+		template <class ValueType>
+		bool Entity::has_shared_value() const {
+			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't determine shared values");
+			return world.shared_values<ValueType>().contains(id);
+		}
+
+		// returns the value of the given type shared by this entity
+		template <class ValueType>
+		const ValueType& Entity::get_shared_value() const {
+			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't access shared values");
+			return world.shared_values<ValueType>().get(id);
+		}
+
+		// sets the tag of the given type on this entity, tags have no state so all share one instance
+		template <class TagType>
+		TagType& Entity::attach(std::true_type) {
+			static TagType tag;
+			auto& tags = world.storage<Tags>();
+			runtime_assert(not tags.has<TagType>(id), *this, " is already tagged with ", Type(typeid(TagType)), ", can't add it again");
+			ensys_trace(Add_Component, id, typeid(TagType).hash_code());
+			if (world.recorder) world.recorder->add_component(id, typeid(TagType));
+			tags.add<TagType>(id);
+			world.update_tag(*this, Tags::bit_of<TagType>());
+			return tag;
+		}
+
+		// clears the tag of the given type on this entity
+		template <class TagType>
+		void Entity::detach(std::true_type) {
+			auto& tags = world.storage<Tags>();
+			runtime_assert(tags.has<TagType>(id), *this, " isn't tagged with ", Type(typeid(TagType)), ", can't remove it");
+			ensys_trace(Remove_Component, id, typeid(TagType).hash_code());
+			if (world.recorder) world.recorder->remove_component(id, typeid(TagType));
+			tags.remove<TagType>(id);
+			world.update_tag(*this, Tags::bit_of<TagType>());
+		}
+
+		// checks whether this entity is tagged with the given type
+		template <class TagType>
+		bool Entity::holds(std::true_type) const {
+			return world.storage<Tags>().has<TagType>(id);
+		}
+
+		// adds plain components (without Component base) to this entity, stored as a row of the table of their types
+		template <class... ComponentTypes>
+		void Entity::add_plain_components(const ComponentTypes&... components) {
+			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't add plain components");
+			ensys_trace(Add_Component, id, typeid(Table<ComponentTypes...>).hash_code());
+			world.thaw(id);
+			world.table<ComponentTypes...>().insert(id, components...);
+			world.update_systems(*this);
+		}
+
+		// removes the plain components of the given types (the row of the table of these types) from this entity
+		template <class... ComponentTypes>
+		void Entity::remove_plain_components() {
+			runtime_assert(is_existing(), "there is no existing entity with id #", id, " can't remove plain components");
+			ensys_trace(Remove_Component, id, typeid(Table<ComponentTypes...>).hash_code());
+			world.thaw(id);
+			world.table<ComponentTypes...>().erase(id);
+			world.update_systems(*this);
+		}
+
 	}
 
 	#ifndef ENSYS_NO_NAMESPACE_ALIAS
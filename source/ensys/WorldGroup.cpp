@@ -0,0 +1,168 @@
+#include "WorldGroup.h"
+
+#include <algorithm>
+
+#include <utilities/Assertions.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		namespace {
+
+			// the weight of the latest tick time in the moving average
+			const float Smoothing = 0.1f;
+
+		}
+
+		WorldGroup::WorldGroup(uint number_of_workers) {
+			number_of_workers = std::max(number_of_workers, 1u);
+			for (uint i = 0; i < number_of_workers; ++i) {
+				workers.emplace_back(new Worker());
+			}
+			for (uint i = 0; i < number_of_workers; ++i) {
+				workers[i]->thread = std::thread(&WorldGroup::work, this, i);
+			}
+		}
+
+		WorldGroup::~WorldGroup() noexcept {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			tick_started.notify_all();
+			for (auto& worker : workers) {
+				worker->thread.join();
+			}
+		}
+
+		void WorldGroup::add(World& world) {
+			runtime_assert(not has(world), world, " already belongs to this world group, can't add it again");
+			Lot<uint> load(workers.size(), 0);
+			for (auto& member : members) {
+				load[member.affinity]++;
+			}
+			Member member;
+			member.world = &world;
+			member.affinity = std::min_element(load.begin(), load.end()) - load.begin();
+			members.push_back(member);
+		}
+
+		void WorldGroup::remove(World& world) {
+			auto iterator = std::find_if(members.begin(), members.end(), [&](const Member& member) { return member.world == &world; });
+			runtime_assert(iterator != members.end(), world, " doesn't belong to this world group, can't remove it");
+			members.erase(iterator);
+		}
+
+		bool WorldGroup::has(const World& world) const {
+			return std::any_of(members.begin(), members.end(), [&](const Member& member) { return member.world == &world; });
+		}
+
+		// fills the queues of the workers by affinity, the members lagging behind the most first
+		void WorldGroup::update(float delta_time, float budget) {
+			if (members.empty()) return;
+			Lot<uint> order(members.size());
+			for (uint i = 0; i < members.size(); ++i) {
+				members[i].pending_delta_time += delta_time;
+				order[i] = i;
+			}
+			std::stable_sort(order.begin(), order.end(), [&](uint a, uint b) {
+				return members[a].pending_delta_time > members[b].pending_delta_time;
+			});
+			for (uint i : order) {
+				workers[members[i].affinity]->queue.push_back(i);
+			}
+			has_deadline = budget > 0.0f;
+			deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(budget));
+			remaining_members = members.size();
+			std::unique_lock<std::mutex> lock(mutex);
+			running_workers = workers.size();
+			tick++;
+			tick_started.notify_all();
+			tick_finished.wait(lock, [this] { return running_workers == 0; });
+		}
+
+		float WorldGroup::get_tick_time(const World& world) const {
+			return member_of(world).tick_time;
+		}
+
+		float WorldGroup::get_average_tick_time(const World& world) const {
+			return member_of(world).average_tick_time;
+		}
+
+		uint WorldGroup::get_number_of_deferrals(const World& world) const {
+			return member_of(world).deferred;
+		}
+
+		uint WorldGroup::get_number_of_worlds() const {
+			return members.size();
+		}
+
+		uint WorldGroup::get_number_of_workers() const {
+			return workers.size();
+		}
+
+		const WorldGroup::Member& WorldGroup::member_of(const World& world) const {
+			auto iterator = std::find_if(members.begin(), members.end(), [&](const Member& member) { return member.world == &world; });
+			runtime_assert(iterator != members.end(), world, " doesn't belong to this world group");
+			return *iterator;
+		}
+
+		// each worker keeps taking members until no queue holds any, then reports the end of its tick
+		void WorldGroup::work(uint worker) {
+			uint64_t last_tick = 0;
+			while (true) {
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					tick_started.wait(lock, [&] { return stopping or tick != last_tick; });
+					if (stopping) return;
+					last_tick = tick;
+				}
+				uint member;
+				while (remaining_members.load() > 0 and take(worker, member)) {
+					run(members[member]);
+					remaining_members--;
+				}
+				std::lock_guard<std::mutex> lock(mutex);
+				if (--running_workers == 0) tick_finished.notify_one();
+			}
+		}
+
+		bool WorldGroup::take(uint worker, uint& member) {
+			{
+				Worker& own = *workers[worker];
+				std::lock_guard<std::mutex> lock(own.mutex);
+				if (not own.queue.empty()) {
+					member = own.queue.front();
+					own.queue.pop_front();
+					return true;
+				}
+			}
+			for (uint i = 1; i < workers.size(); ++i) {
+				Worker& victim = *workers[(worker + i) % workers.size()];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (not victim.queue.empty()) {
+					member = victim.queue.back();
+					victim.queue.pop_back();
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void WorldGroup::run(Member& member) {
+			if (has_deadline and std::chrono::steady_clock::now() > deadline) {
+				member.deferred++;
+				return;
+			}
+			auto start = std::chrono::steady_clock::now();
+			member.world->update(member.pending_delta_time);
+			member.tick_time = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+			member.average_tick_time += (member.tick_time - member.average_tick_time) * (member.average_tick_time == 0.0f ? 1.0f : Smoothing);
+			member.pending_delta_time = 0.0f;
+			member.deferred = 0;
+		}
+
+	}
+
+}
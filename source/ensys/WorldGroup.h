@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <ensys/World.h>
+
+#include <utilities/Types.h>
+
+namespace tenjix {
+
+	namespace ensys {
+
+		// updates many independent worlds concurrently on a shared pool of worker threads
+		//
+		// thread safety: each world is updated by exactly one worker at a time, so worlds are safe to update concurrently
+		// as long as they share no entities, systems, resources or storage allocators (mapped chunk files included).
+		// everything ensys keeps globally is safe: type indices are atomic, binary trace buffers are per thread
+		// and chunk allocation on the heap uses malloc. the formatted trace() and log output of the utilities
+		// writes to one global sink without synchronization, so it has to be compiled out (or synchronized by the sink)
+		// when worlds run concurrently; ensys_trace is the thread safe alternative on hot paths.
+		class WorldGroup final {
+
+			struct Member {
+				World* world;
+				// the worker which updates this world unless its world gets stolen, keeps caches warm
+				uint affinity;
+				// the time accumulated since the last update of this world
+				float pending_delta_time = 0.0f;
+				// the duration of the last update and the exponential moving average of all updates in seconds
+				float tick_time = 0.0f;
+				float average_tick_time = 0.0f;
+				// the number of group updates this world was deferred in a row because the budget was exceeded
+				uint deferred = 0;
+			};
+
+			struct Worker {
+				std::thread thread;
+				std::mutex mutex;
+				// the indices of the members to update in this tick, own work is taken from the front, stolen from the back
+				std::deque<uint> queue;
+			};
+
+			Lot<Member> members;
+			Lot<unique<Worker>> workers;
+
+			std::mutex mutex;
+			std::condition_variable tick_started;
+			std::condition_variable tick_finished;
+			// incremented with each tick, the workers wait for it to change
+			uint64_t tick = 0;
+			bool stopping = false;
+
+			std::atomic<uint> remaining_members { 0 };
+			uint running_workers = 0;
+
+			std::chrono::steady_clock::time_point deadline;
+			bool has_deadline = false;
+
+		public:
+
+			// starts the given number of worker threads
+			explicit WorldGroup(uint number_of_workers = std::thread::hardware_concurrency());
+
+			WorldGroup(const WorldGroup&) = delete;
+			WorldGroup& operator=(const WorldGroup&) = delete;
+
+			// stops and joins the worker threads
+			~WorldGroup() noexcept;
+
+			// adds a world to this group, assigning it to the least loaded worker
+			void add(World& world);
+
+			// removes a world from this group, must not be called while updating
+			void remove(World& world);
+
+			// checks whether the world belongs to this group
+			bool has(const World& world) const;
+
+			// updates all worlds concurrently and returns when all of them are done
+			// with a budget (in seconds), worlds not started before the budget is exhausted are deferred to the next update,
+			// which passes them the accumulated time and starts the worlds lagging behind the most first
+			void update(float delta_time, float budget = 0.0f);
+
+			// returns the duration of the last update of the given world in seconds
+			float get_tick_time(const World& world) const;
+
+			// returns the exponential moving average of the update durations of the given world in seconds
+			float get_average_tick_time(const World& world) const;
+
+			// returns the number of updates the given world was deferred in a row
+			uint get_number_of_deferrals(const World& world) const;
+
+			uint get_number_of_worlds() const;
+
+			uint get_number_of_workers() const;
+
+		private:
+
+			const Member& member_of(const World& world) const;
+
+			void work(uint worker);
+
+			// takes the next member from the front of the own queue, or steals one from the back of another queue
+			bool take(uint worker, uint& member);
+
+			void run(Member& member);
+
+		};
+
+	}
+
+}